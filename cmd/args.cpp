@@ -1,7 +1,11 @@
 #include "args.h"
 
+#include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 auto Args::help() -> void {
     std::cerr << "usage: " << argv[0] << " [OPTIONS] <NUM SAMPLES> <FILENAME>\n"
@@ -12,6 +16,8 @@ auto Args::help() -> void {
               << "\n"
               << "OPTIONS:\n"
               << "\t-s <seed>        the random seed\n"
+              << "\t-m <megabytes>   cap the memory used by the shared cache\n"
+              << "\t-t               time the shared cache against per-batch caches\n"
               << std::endl;
     std::exit(1);
 }
@@ -40,6 +46,15 @@ auto Args::parse_num_sample(std::string n_str) -> void {
     this->n = n;
 }
 
+auto Args::parse_cache_limit(std::string mb_str) -> void {
+    auto mb = std::stof(mb_str);
+    if (mb <= 0) {
+        std::cerr << "error: cache limit must be positive\n" << std::endl;
+        help();
+    }
+    this->cache_limit = static_cast<std::size_t>(mb * (1 << 20));
+}
+
 auto Args::parse_filename(std::string filename) -> void {
     this->filename = filename;
 }
@@ -51,6 +66,10 @@ auto Args::parse() -> void{
         std::string arg = argv[i];
         if (arg == "-s") {
             parse_seed(argv[++i]);
+        } else if (arg == "-m") {
+            parse_cache_limit(argv[++i]);
+        } else if (arg == "-t") {
+            compare = true;
         } else if (p == 0) {
             parse_num_sample(arg);
             ++p;
@@ -74,3 +93,85 @@ auto Args::parse() -> void{
 Args::Args(int argc, char **argv): argc{argc}, argv{argv} {
     this->parse();
 }
+
+auto Flags::usage(char const *cmd) const -> std::string {
+    auto ss = std::stringstream{};
+    ss << "usage: " << cmd;
+    for (auto const& flag: this->flags) {
+        ss << " [" << flag.name << " <" << flag.value << ">]";
+    }
+    return ss.str();
+}
+
+auto Flags::add(std::string name, std::string value, std::size_t& target) -> Flags& {
+    this->flags.push_back({ std::move(name), std::move(value), [&target](std::string const& arg) {
+        target = std::stoul(arg);
+    }});
+    return *this;
+}
+
+auto Flags::add(std::string name, std::string value, unsigned int& target) -> Flags& {
+    this->flags.push_back({ std::move(name), std::move(value), [&target](std::string const& arg) {
+        target = static_cast<unsigned int>(std::stoul(arg));
+    }});
+    return *this;
+}
+
+auto Flags::add(std::string name, std::string value, std::string& target) -> Flags& {
+    this->flags.push_back({ std::move(name), std::move(value), [&target](std::string const& arg) {
+        target = arg;
+    }});
+    return *this;
+}
+
+auto Flags::parse(int argc, char **argv) const -> void {
+    for (auto i = 1; i < argc; ++i) {
+        auto const arg = std::string(argv[i]);
+        auto const flag = std::find_if(std::begin(this->flags), std::end(this->flags),
+                                       [&arg](Flag const& f) { return f.name == arg; });
+        if (flag == std::end(this->flags) || i + 1 == argc) {
+            throw this->usage(argv[0]);
+        }
+        try {
+            flag->set(argv[++i]);
+        } catch (std::logic_error const&) {
+            throw this->usage(argv[0]);
+        }
+    }
+}
+
+auto read_strings(std::string const& filename) -> std::vector<std::string> {
+    auto file = std::ifstream(filename);
+    if (!file) {
+        throw std::runtime_error("cannot open " + filename);
+    }
+
+    auto split = [](std::string line) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        auto fields = std::vector<std::string>{};
+        auto ss = std::stringstream(line);
+        for (auto field = std::string{}; std::getline(ss, field, ',');) {
+            fields.push_back(field);
+        }
+        return fields;
+    };
+
+    auto line = std::string{};
+    std::getline(file, line);
+    auto const header = split(line);
+    auto const column = std::find(std::begin(header), std::end(header), "string") - std::begin(header);
+    if (column == static_cast<std::ptrdiff_t>(std::size(header))) {
+        throw std::runtime_error(filename + " has no string column");
+    }
+
+    auto strs = std::vector<std::string>{};
+    while (std::getline(file, line)) {
+        auto const fields = split(line);
+        if (column < static_cast<std::ptrdiff_t>(std::size(fields))) {
+            strs.push_back(fields[column]);
+        }
+    }
+    return strs;
+}
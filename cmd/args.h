@@ -1,7 +1,9 @@
 #pragma once
 
+#include <functional>
 #include <random>
 #include <string>
+#include <vector>
 
 class Args {
     private:
@@ -12,6 +14,7 @@ class Args {
         auto help() -> void;
         auto parse_seed(std::string seed_str) -> void;
         auto parse_num_sample(std::string n_str) -> void;
+        auto parse_cache_limit(std::string mb_str) -> void;
         auto parse_filename(std::string filename) -> void;
         auto parse() -> void;
 
@@ -19,7 +22,36 @@ class Args {
         std::size_t n;
         std::string filename;
         std::random_device::result_type seed;
+        std::size_t cache_limit = 0;
+        bool compare = false;
 
         Args(int argc, char **argv);
 };
 
+
+// The `Flags` parse the `-x <value>` options taken by the benchmarks. Each flag
+// is registered along with the variable it sets, which keeps its default value
+// unless the flag is given. A malformed command line throws the usage message
+// as a `std::string`.
+class Flags {
+    private:
+        struct Flag {
+            std::string name;
+            std::string value;
+            std::function<void(std::string const&)> set;
+        };
+
+        std::vector<Flag> flags;
+
+        auto usage(char const *cmd) const -> std::string;
+
+    public:
+        auto add(std::string name, std::string value, std::size_t& target) -> Flags&;
+        auto add(std::string name, std::string value, unsigned int& target) -> Flags&;
+        auto add(std::string name, std::string value, std::string& target) -> Flags&;
+
+        auto parse(int argc, char **argv) const -> void;
+};
+
+// Read the `string` column of a CSV file such as `perf/data/str_sa.csv`.
+auto read_strings(std::string const& filename) -> std::vector<std::string>;
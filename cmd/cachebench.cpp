@@ -0,0 +1,72 @@
+#include "args.h"
+#include "random.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <pathways/string.h>
+#include <tuple>
+
+using namespace std::chrono;
+
+template <template <typename, typename> class CachePolicy>
+using StringContext = pathways::Context<std::string, pathways::disassembly_type<std::string>::value, CachePolicy>;
+
+// Compute the assembly index of each string in a fresh context, returning the
+// indices, the total runtime and the mean cache size.
+template <template <typename, typename> class CachePolicy>
+auto run(std::vector<std::string> const& strs) -> std::tuple<std::vector<uint32_t>, double, double> {
+    auto indices = std::vector<uint32_t>{};
+    auto elapsed = duration<double>{0};
+    auto size = 0.0;
+    for (auto const& str: strs) {
+        StringContext<CachePolicy> ctx;
+        auto start = high_resolution_clock::now();
+        indices.push_back(ctx.assembly_index(str));
+        auto stop = high_resolution_clock::now();
+        elapsed += stop - start;
+        size += static_cast<double>(ctx.cache_size()) / std::size(strs);
+    }
+    return { indices, elapsed.count(), size };
+}
+
+auto main(int argc, char **argv) -> int {
+    auto seed = std::random_device{}();
+    auto n = std::size_t{5};
+    auto max_len = std::size_t{200};
+    try {
+        Flags{}.add("-s", "seed", seed).add("-n", "samples", n).add("-l", "max length", max_len).parse(argc, argv);
+    } catch (std::string &s) {
+        std::cerr << s << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(seed);
+
+    std::cout << std::setw(8) << "length"
+              << std::setw(14) << "cache size"
+              << std::setw(14) << "map (s)"
+              << std::setw(14) << "flat (s)"
+              << std::setw(14) << "compact (s)"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (std::size_t len = 25; len <= max_len; len += 25) {
+        auto strs = std::vector<std::string>(n);
+        std::generate(std::begin(strs), std::end(strs), [&]() { return random_string(len, gen); });
+
+        auto const [map_indices, map_time, size] = run<pathways::MapCache>(strs);
+        auto const [flat_indices, flat_time, flat_size] = run<pathways::FlatCache>(strs);
+        auto const [compact_indices, compact_time, compact_size] = run<pathways::CompactCache>(strs);
+        if (map_indices != flat_indices || map_indices != compact_indices) {
+            std::cerr << "error: cache policies disagree for length " << len << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << len
+                  << std::setw(14) << static_cast<std::size_t>(size)
+                  << std::setw(14) << map_time
+                  << std::setw(14) << flat_time
+                  << std::setw(14) << compact_time
+                  << std::setw(10) << std::setprecision(3) << map_time / std::min(flat_time, compact_time)
+                  << std::setprecision(6) << std::endl;
+    }
+}
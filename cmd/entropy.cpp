@@ -1,5 +1,6 @@
 #include "args.h"
 #include "random.h"
+#include "sweep.h"
 #include <mgl2/mgl.h>
 #include <pathways/string.h>
 
@@ -49,7 +50,7 @@ auto entropy(std::string const& str) {
 }
 
 template <typename Generator>
-auto entropy(mglGraph &gr, Generator &gen, size_t len, size_t num_str, double p_step) -> mglGraph& {
+auto entropy(mglGraph &gr, Sweep &sweep, Generator &gen, size_t len, size_t num_str, double p_step) -> mglGraph& {
     std::size_t const n_step = 1 + std::floor(1 / p_step);
     auto data = PlotData{
         static_cast<long>(num_str * n_step),
@@ -63,10 +64,10 @@ auto entropy(mglGraph &gr, Generator &gen, size_t len, size_t num_str, double p_
     size_t j = 0;
     for (std::size_t i = 0; i < n_step; ++i, p += p_step) {
         for (std::size_t n = 0; n < num_str; ++n, ++j) {
-            pathways::Context<std::string> ctx;
             auto const str = random_string(len, gen, p);
+            sweep.batch();
             data.x.a[j] = entropy(str);
-            data.y.a[j] = ctx.assembly_index(str);
+            data.y.a[j] = sweep.assembly_index(str);
         }
     }
 
@@ -78,8 +79,12 @@ auto main(int argc, char **argv) -> int {
 
     std::mt19937 gen(args.seed);
 
+    Sweep sweep{args.cache_limit, args.compare};
+
     mglGraph gr;
     gr.SuppressWarn(true);
-    entropy(gr, gen, 100, args.n, 0.01);
+    entropy(gr, sweep, gen, 100, args.n, 0.01);
     gr.WriteFrame(args.filename.c_str());
+
+    sweep.report(std::cout);
 }
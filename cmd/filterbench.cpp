@@ -0,0 +1,70 @@
+#include "args.h"
+#include "random.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <pathways/string.h>
+#include <tuple>
+
+using namespace std::chrono;
+
+template <template <typename, typename> class CachePolicy>
+using StringContext = pathways::Context<std::string, pathways::disassembly_type<std::string>::value, CachePolicy>;
+
+// Time the assembly index of each string in a fresh ("cold") context, and
+// then again in the now populated ("warm") context. Before the warm run, the
+// entries with the largest indices — including the string's own — are pruned
+// so that the recursion runs again, but almost every lookup hits.
+template <template <typename, typename> class CachePolicy>
+auto run(std::vector<std::string> const& strs) -> std::tuple<double, double> {
+    auto cold = duration<double>{0};
+    auto warm = duration<double>{0};
+    for (auto const& str: strs) {
+        StringContext<CachePolicy> ctx;
+        auto start = high_resolution_clock::now();
+        auto const c = ctx.assembly_index(str);
+        cold += high_resolution_clock::now() - start;
+
+        ctx.prune(pathways::Retention::index_at_most(c - 1));
+        start = high_resolution_clock::now();
+        if (ctx.assembly_index(str) != c) {
+            throw std::runtime_error("warm and cold assembly indices disagree");
+        }
+        warm += high_resolution_clock::now() - start;
+    }
+    return { cold.count(), warm.count() };
+}
+
+auto main(int argc, char **argv) -> int {
+    auto seed = std::random_device{}();
+    auto n = std::size_t{5};
+    auto max_len = std::size_t{200};
+    try {
+        Flags{}.add("-s", "seed", seed).add("-n", "samples", n).add("-l", "max length", max_len).parse(argc, argv);
+    } catch (std::string &s) {
+        std::cerr << s << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(seed);
+
+    std::cout << std::setw(8) << "length"
+              << std::setw(14) << "flat cold"
+              << std::setw(14) << "filter cold"
+              << std::setw(14) << "flat warm"
+              << std::setw(14) << "filter warm" << std::endl;
+
+    for (std::size_t len = 25; len <= max_len; len += 25) {
+        auto strs = std::vector<std::string>(n);
+        std::generate(std::begin(strs), std::end(strs), [&]() { return random_string(len, gen); });
+
+        auto const [flat_cold, flat_warm] = run<pathways::FlatCache>(strs);
+        auto const [filter_cold, filter_warm] = run<pathways::FilteredCache>(strs);
+
+        std::cout << std::setw(8) << len
+                  << std::setw(14) << flat_cold
+                  << std::setw(14) << filter_cold
+                  << std::setw(14) << flat_warm
+                  << std::setw(14) << filter_warm << std::endl;
+    }
+}
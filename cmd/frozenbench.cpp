@@ -0,0 +1,132 @@
+#include "args.h"
+#include "random.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <pathways/frozen.h>
+#include <pathways/string.h>
+#include <thread>
+
+// Warm a context over a batch of random strings, freeze it, and compare how
+// quickly the warm `FlatCache` and the `FrozenCache` answer lookups of every
+// cached pair (hits) and of as many pairs which were never cached (misses),
+// first on one thread and then on several threads sharing the same cache.
+// Builds which collect statistics (`make STATS=1`) only use one thread.
+
+using namespace std::chrono;
+
+using Key = std::pair<std::size_t, std::size_t>;
+
+// Get the number of millions of lookups of `keys` a cache answers per second
+// when `threads` threads each look up every key.
+template <typename Cache>
+auto rate(Cache const& cache, std::vector<Key> const& keys, std::size_t threads) -> double {
+    auto found = std::vector<std::size_t>(threads);
+    auto const lookup = [&cache, &keys, &found](std::size_t t) {
+        auto count = std::size_t{0};
+        for (auto const& key: keys) {
+            count += cache.find(key).has_value();
+        }
+        found[t] = count;
+    };
+
+    auto const start = high_resolution_clock::now();
+    auto workers = std::vector<std::thread>{};
+    for (std::size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(lookup, t);
+    }
+    lookup(0);
+    for (auto& worker: workers) {
+        worker.join();
+    }
+    duration<double> const elapsed = high_resolution_clock::now() - start;
+
+    if (std::count(std::begin(found), std::end(found), found[0]) != static_cast<std::ptrdiff_t>(threads)) {
+        throw std::runtime_error("threads disagree on the number of keys found");
+    }
+    return threads * std::size(keys) / elapsed.count() / 1e6;
+}
+
+auto main(int argc, char **argv) -> int {
+    auto seed = std::random_device{}();
+    auto n = std::size_t{20};
+    auto len = std::size_t{100};
+    auto threads = std::size_t{std::max(1u, std::thread::hardware_concurrency())};
+    try {
+        Flags{}.add("-s", "seed", seed).add("-n", "samples", n).add("-l", "length", len).add("-t", "threads", threads).parse(argc, argv);
+    } catch (std::string &s) {
+        std::cerr << s << std::endl;
+        return 1;
+    }
+    threads = std::max(std::size_t{1}, threads);
+#ifdef PATHWAYS_STATISTICS
+    // Lookups update the caches' statistics, which aren't synchronised, so
+    // the caches can't be shared between threads in this build.
+    if (threads > 1) {
+        std::cerr << "warning: built with PATHWAYS_STATISTICS, so only timing lookups on one thread\n" << std::endl;
+        threads = 1;
+    }
+#endif
+
+    std::mt19937 gen(seed);
+
+    auto strs = std::vector<std::string>(n);
+    std::generate(std::begin(strs), std::end(strs), [&]() { return random_string(len, gen); });
+
+    pathways::Context<std::string> warm;
+    auto indices = std::vector<uint32_t>{};
+    auto start = high_resolution_clock::now();
+    for (auto const& str: strs) {
+        indices.push_back(warm.assembly_index(str));
+    }
+    duration<double> const warming = high_resolution_clock::now() - start;
+
+    start = high_resolution_clock::now();
+    auto frozen = pathways::freeze(warm);
+    duration<double> const freezing = high_resolution_clock::now() - start;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (frozen.assembly_index(strs[i]) != indices[i]) {
+            std::cerr << "error: the frozen context disagrees with the warm one" << std::endl;
+            return 1;
+        }
+    }
+
+    auto const& flat = warm.coassembly_cache();
+    auto const& ice = frozen.coassembly_cache();
+
+    auto hits = std::vector<Key>{};
+    flat.for_each([&hits](Key const& key, uint32_t) { hits.push_back(key); });
+    std::shuffle(std::begin(hits), std::end(hits), gen);
+
+    auto misses = std::vector<Key>(std::size(hits));
+    std::generate(std::begin(misses), std::end(misses), [&gen]() {
+        return Key{ std::uniform_int_distribution<std::size_t>{}(gen), std::uniform_int_distribution<std::size_t>{}(gen) };
+    });
+
+    std::cout << "warmed " << std::size(hits) << " pairs over " << n << " strings of length " << len
+              << " in " << warming.count() << "s, froze them in " << freezing.count() << "s\n"
+              << "frozen: " << ice.levels() << " levels, " << ice.spilled() << " spilled\n" << std::endl;
+
+    std::cout << std::setw(10) << "cache"
+              << std::setw(12) << "MiB"
+              << std::setw(10) << "threads"
+              << std::setw(16) << "hits (Mops/s)"
+              << std::setw(16) << "misses (Mops/s)" << std::endl;
+
+    auto const report = [&](char const *name, auto const& cache) {
+        for (auto const t: { std::size_t{1}, threads }) {
+            std::cout << std::setw(10) << name
+                      << std::setw(12) << cache.bytes() / (1024.0 * 1024.0)
+                      << std::setw(10) << t
+                      << std::setw(16) << rate(cache, hits, t)
+                      << std::setw(16) << rate(cache, misses, t) << std::endl;
+            if (threads == 1) {
+                break;
+            }
+        }
+    };
+    report("flat", flat);
+    report("frozen", ice);
+}
@@ -0,0 +1,177 @@
+#include "args.h"
+#include "random.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <pathways/search.h>
+#include <pathways/simd.h>
+#include <pathways/string.h>
+#include <tuple>
+
+using namespace std::chrono;
+
+template <typename Hash>
+using StringContext = pathways::Context<std::string, pathways::disassembly_type<std::string>::value, pathways::FlatCache, Hash>;
+
+template <typename Generator>
+auto random_bytes(std::size_t n, Generator &gen) -> std::string {
+    std::uniform_int_distribution<int> d(0, 255);
+
+    auto str = std::string(n, '\0');
+    std::generate_n(std::begin(str), n, [&gen, &d]() { return static_cast<char>(d(gen)); });
+
+    return str;
+}
+
+// Get the mean number of nanoseconds it takes `hash` to hash one of `strs`.
+template <typename Hash>
+auto time(std::vector<std::string> const& strs, std::size_t repeats, Hash hash) -> double {
+    auto sink = std::size_t{0};
+    auto start = high_resolution_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        for (auto const& str: strs) {
+            sink += hash(str);
+        }
+    }
+    duration<double, std::nano> elapsed = high_resolution_clock::now() - start;
+    if (sink == 42) {
+        std::cerr << "";
+    }
+    return elapsed.count() / (repeats * std::size(strs));
+}
+
+// Get the mean number of nanoseconds it takes `search` to determine whether
+// each needle occurs in its haystack.
+auto time_search(std::vector<std::pair<std::string, std::string>> const& queries, std::size_t repeats, pathways::simd::Search search) -> double {
+    auto found = std::size_t{0};
+    auto start = high_resolution_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        for (auto const& [haystack, needle]: queries) {
+            found += pathways::simd_contains(haystack, needle, search);
+        }
+    }
+    duration<double, std::nano> elapsed = high_resolution_clock::now() - start;
+    if (found == 42) {
+        std::cerr << "";
+    }
+    return elapsed.count() / (repeats * std::size(queries));
+}
+
+template <typename Hash>
+auto assemble(std::vector<std::string> const& strs) -> std::tuple<std::vector<uint32_t>, double> {
+    auto indices = std::vector<uint32_t>{};
+    auto elapsed = duration<double>{0};
+    for (auto const& str: strs) {
+        StringContext<Hash> ctx;
+        auto start = high_resolution_clock::now();
+        indices.push_back(ctx.assembly_index(str));
+        elapsed += high_resolution_clock::now() - start;
+    }
+    return { indices, elapsed.count() };
+}
+
+auto kernel_name(pathways::HashKernel kernel) -> char const * {
+    switch (kernel) {
+        case pathways::HashKernel::avx2:
+            return "avx2";
+        case pathways::HashKernel::sse:
+            return "sse";
+        default:
+            return "scalar";
+    }
+}
+
+auto main(int argc, char **argv) -> int {
+    auto seed = std::random_device{}();
+    auto n = std::size_t{1000};
+    auto repeats = std::size_t{1000};
+    try {
+        Flags{}.add("-s", "seed", seed).add("-n", "samples", n).add("-r", "repeats", repeats).parse(argc, argv);
+    } catch (std::string &s) {
+        std::cerr << s << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(seed);
+
+    using pathways::HashKernel;
+    std::cout << "dispatching to the " << kernel_name(pathways::hash_kernel()) << " kernel\n" << std::endl;
+
+    std::cout << std::setw(8) << "length"
+              << std::setw(10) << "alphabet"
+              << std::setw(12) << "std (ns)"
+              << std::setw(12) << "scalar (ns)"
+              << std::setw(12) << "sse (ns)"
+              << std::setw(12) << "avx2 (ns)" << std::endl;
+
+    for (auto const len: { 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 160, 200 }) {
+        for (auto const binary: { true, false }) {
+            auto strs = std::vector<std::string>(n);
+            std::generate(std::begin(strs), std::end(strs), [&]() {
+                return binary ? random_string(len, gen) : random_bytes(len, gen);
+            });
+
+            auto const simd = [](HashKernel which) {
+                auto const kernel = pathways::simd::kernel(which);
+                return [kernel](std::string const& str) { return pathways::simd_hash(str, kernel); };
+            };
+            std::cout << std::setw(8) << len
+                      << std::setw(10) << (binary ? "binary" : "bytes")
+                      << std::setw(12) << time(strs, repeats, std::hash<std::string>{})
+                      << std::setw(12) << time(strs, repeats, simd(HashKernel::scalar))
+                      << std::setw(12) << time(strs, repeats, simd(HashKernel::sse))
+                      << std::setw(12) << time(strs, repeats, simd(HashKernel::avx2)) << std::endl;
+        }
+    }
+
+    std::cout << '\n'
+              << std::setw(8) << "length"
+              << std::setw(10) << "alphabet"
+              << std::setw(12) << "find (ns)"
+              << std::setw(12) << "sse (ns)"
+              << std::setw(12) << "avx2 (ns)" << std::endl;
+
+    // Search each haystack for a needle of up to half its length, half of
+    // which are cut from the haystack itself.
+    for (auto const len: { 32, 64, 128, 200 }) {
+        for (auto const binary: { true, false }) {
+            auto queries = std::vector<std::pair<std::string, std::string>>(n);
+            for (auto& [haystack, needle]: queries) {
+                haystack = binary ? random_string(len, gen) : random_bytes(len, gen);
+                auto const k = std::uniform_int_distribution<std::size_t>(2, len / 2)(gen);
+                if (gen() % 2) {
+                    needle = haystack.substr(std::uniform_int_distribution<std::size_t>(0, len - k)(gen), k);
+                } else {
+                    needle = binary ? random_string(k, gen) : random_bytes(k, gen);
+                }
+            }
+
+            std::cout << std::setw(8) << len
+                      << std::setw(10) << (binary ? "binary" : "bytes")
+                      << std::setw(12) << time_search(queries, repeats, pathways::simd::search_kernel(HashKernel::scalar))
+                      << std::setw(12) << time_search(queries, repeats, pathways::simd::search_kernel(HashKernel::sse))
+                      << std::setw(12) << time_search(queries, repeats, pathways::simd::search_kernel(HashKernel::avx2)) << std::endl;
+        }
+    }
+
+    std::cout << '\n'
+              << std::setw(8) << "length"
+              << std::setw(12) << "std (s)"
+              << std::setw(12) << "simd (s)" << std::endl;
+
+    for (std::size_t len = 25; len <= 200; len += 25) {
+        auto strs = std::vector<std::string>(5);
+        std::generate(std::begin(strs), std::end(strs), [&]() { return random_string(len, gen); });
+
+        auto const [std_indices, std_time] = assemble<std::hash<std::string>>(strs);
+        auto const [simd_indices, simd_time] = assemble<pathways::StringHash>(strs);
+        if (std_indices != simd_indices) {
+            std::cerr << "error: hashers disagree for length " << len << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << len
+                  << std::setw(12) << std_time
+                  << std::setw(12) << simd_time << std::endl;
+    }
+}
@@ -0,0 +1,364 @@
+#include "args.h"
+#include "random.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <pathways/hash.h>
+#include <pathways/simd.h>
+#include <pathways/string.h>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Record the stream of cache operations a `Context<std::string>` performs over
+// a workload, and replay it against a handful of candidate hash functions and
+// cache layouts. For each hash we report how many distinct objects share a
+// full hash with another, how many collide in the low bits used to index a
+// table (with and without the `mix` finalizer the caches apply), and how fast
+// it hashes the recorded objects. For each layout we report the mean and
+// worst probe lengths and how quickly it replays the stream.
+//
+// This binary is always built with `PATHWAYS_STATISTICS` so that the tables
+// record their probe lengths; that cost is the same for every layout, but it
+// does mean the replay rates are lower than the caches would manage in a
+// normal build.
+
+using namespace std::chrono;
+
+// The operations a context performs on its caches. A `reset` marks the start
+// of a fresh context.
+enum class Kind : uint8_t {
+    reset,
+    find,
+    insert,
+    find_pair,
+    insert_pair,
+};
+
+struct Op {
+    Kind kind;
+    uint32_t x;
+    uint32_t y;
+    uint32_t value;
+};
+
+// A `Trace` numbers every distinct object a context hashes, and records the
+// order in which objects were hashed and the cache operations performed on
+// their IDs.
+struct Trace {
+    std::vector<std::string> objects;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<uint32_t> hashed;
+    std::vector<Op> ops;
+};
+
+// The `Recorder` "hashes" each object to its ID in the trace, so the recorded
+// operations are exact: no two objects share a key.
+struct Recorder {
+    Trace *trace = nullptr;
+
+    auto operator()(std::string const& str) const -> std::size_t {
+        auto const [iter, inserted] = this->trace->ids.emplace(str, static_cast<uint32_t>(std::size(this->trace->objects)));
+        if (inserted) {
+            this->trace->objects.push_back(str);
+        }
+        this->trace->hashed.push_back(iter->second);
+        return iter->second;
+    }
+};
+
+// The `Recording<Key, Store>` policy logs every lookup and insertion to a
+// trace before passing it on to a `FlatCache`.
+template <typename Key, typename Store>
+class Recording {
+    private:
+        Trace *_trace = nullptr;
+        pathways::FlatCache<Key, Store> _table;
+
+        static auto ids(std::size_t key) noexcept -> std::pair<uint32_t, uint32_t> {
+            return { static_cast<uint32_t>(key), 0 };
+        }
+
+        static auto ids(std::pair<std::size_t, std::size_t> const& key) noexcept -> std::pair<uint32_t, uint32_t> {
+            return { static_cast<uint32_t>(key.first), static_cast<uint32_t>(key.second) };
+        }
+
+        static constexpr bool pairs = !std::is_same_v<Key, std::size_t>;
+
+        auto log(Kind kind, Key const& key, Store value = 0) const -> void {
+            if (this->_trace) {
+                auto const [x, y] = ids(key);
+                this->_trace->ops.push_back({ kind, x, y, value });
+            }
+        }
+
+    public:
+        Recording() = default;
+
+        explicit Recording(Trace *trace): _trace{trace} {}
+
+        auto find(Key const& key) const -> std::optional<Store> {
+            this->log(pairs ? Kind::find_pair : Kind::find, key);
+            return this->_table.find(key);
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            this->log(pairs ? Kind::insert_pair : Kind::insert, key, store);
+            return this->_table.insert(key, store);
+        }
+
+        auto size() const noexcept -> std::size_t { return this->_table.size(); }
+        auto capacity() const noexcept -> std::size_t { return this->_table.capacity(); }
+        auto evictions() const noexcept -> std::size_t { return 0; }
+        auto bytes() const noexcept -> std::size_t { return this->_table.bytes(); }
+        auto probe_lengths() const noexcept -> pathways::ProbeHistogram const& { return this->_table.probe_lengths(); }
+        auto clear() noexcept -> void { this->_table.clear(); }
+        auto reserve(std::size_t n) -> void { this->_table.reserve(n); }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            return this->_table.erase_if(pred);
+        }
+};
+
+using RecordingContext = pathways::Context<std::string, pathways::disassembly_type<std::string>::value, Recording, Recorder>;
+
+// Compute the assembly index of each string in a fresh context, as `bin/sa`
+// does, recording what the contexts do.
+auto record(std::vector<std::string> const& strs) -> Trace {
+    auto trace = Trace{};
+    for (auto const& str: strs) {
+        trace.ops.push_back({ Kind::reset, 0, 0, 0 });
+        auto ctx = RecordingContext{
+            RecordingContext::assembly_cache_type{&trace},
+            RecordingContext::coassembly_cache_type{&trace},
+            Recorder{&trace}
+        };
+        ctx.assembly_index(str);
+    }
+    return trace;
+}
+
+// A deliberately naive slot hash, which uses the low bits of a hash as they
+// are and combines pairs linearly. This is what a table sees if it trusts the
+// hash function to scatter keys on its own.
+struct RawKeyHash {
+    auto operator()(std::size_t key) const noexcept -> std::size_t {
+        return key;
+    }
+
+    auto operator()(std::pair<std::size_t, std::size_t> const& key) const noexcept -> std::size_t {
+        return key.first * 31 + key.second;
+    }
+};
+
+template <typename Key, typename Store>
+using Flat = pathways::FlatCache<Key, Store>;
+
+template <typename Key, typename Store>
+using RawFlat = pathways::FlatCache<Key, Store, RawKeyHash>;
+
+template <typename Key, typename Store>
+using Compact = pathways::CompactCache<Key, Store>;
+
+// Fowler–Noll–Vo (FNV-1a): a simple byte-at-a-time hash, included as a
+// baseline with notoriously weak low bits on short keys.
+struct Fnv1a {
+    auto operator()(std::string const& str) const noexcept -> std::size_t {
+        auto h = std::uint64_t{0xcbf29ce484222325ull};
+        for (auto const c: str) {
+            h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+        return h;
+    }
+};
+
+struct Polynomial {
+    auto operator()(std::string const& str) const noexcept -> std::size_t {
+        return pathways::PrefixHash::hash(str);
+    }
+};
+
+struct Result {
+    double mean_probe = 0;
+    std::size_t long_probes = 0;
+    double rate = 0;
+};
+
+// Replay a trace against a layout whose assembly and coassembly tables are a
+// `Policy`, keying objects on `keys`. Returns the mean probe length, the
+// number of probes of `bins - 1` or more slots and the operations per second.
+template <template <typename, typename> class Policy>
+auto replay(Trace const& trace, std::vector<std::size_t> const& keys, float load_factor = 0.5f) -> Result {
+    using Single = Policy<std::size_t, uint32_t>;
+    using Pairs = Policy<std::pair<std::size_t, std::size_t>, uint32_t>;
+
+    auto histogram = pathways::ProbeHistogram{};
+    auto single = Single{};
+    auto pairs = Pairs{};
+    auto const configure = [load_factor](auto& table) {
+        if constexpr (std::is_same_v<Policy<std::size_t, uint32_t>, Flat<std::size_t, uint32_t>> ||
+                      std::is_same_v<Policy<std::size_t, uint32_t>, RawFlat<std::size_t, uint32_t>>) {
+            table.max_load_factor(load_factor);
+        }
+    };
+
+    auto sink = std::size_t{0};
+    auto start = high_resolution_clock::now();
+    for (auto const& op: trace.ops) {
+        switch (op.kind) {
+            case Kind::reset:
+                histogram += single.probe_lengths();
+                histogram += pairs.probe_lengths();
+                single = Single{};
+                pairs = Pairs{};
+                configure(single);
+                configure(pairs);
+                break;
+            case Kind::find:
+                sink += single.find(keys[op.x]).value_or(0);
+                break;
+            case Kind::insert:
+                single.insert(keys[op.x], op.value);
+                break;
+            case Kind::find_pair:
+                sink += pairs.find(std::minmax(keys[op.x], keys[op.y])).value_or(0);
+                break;
+            case Kind::insert_pair:
+                pairs.insert(std::minmax(keys[op.x], keys[op.y]), op.value);
+                break;
+        }
+    }
+    duration<double> elapsed = high_resolution_clock::now() - start;
+    histogram += single.probe_lengths();
+    histogram += pairs.probe_lengths();
+    if (sink == 42) {
+        std::cerr << "";
+    }
+
+    auto weighted = 0.0;
+    for (std::size_t i = 0; i < pathways::ProbeHistogram::bins; ++i) {
+        weighted += static_cast<double>(i) * histogram[i];
+    }
+    auto const total = histogram.total();
+    return {
+        total == 0 ? 0.0 : weighted / total,
+        histogram[pathways::ProbeHistogram::bins - 1],
+        std::size(trace.ops) / elapsed.count()
+    };
+}
+
+// Count the keys which land in an already occupied slot of a table with at
+// least twice as many slots as keys, when indexed by `slot(key) & mask`.
+template <typename Slot>
+auto slot_collisions(std::vector<std::size_t> const& keys, Slot slot) -> std::size_t {
+    auto slots = std::size_t{8};
+    while (slots < 2 * std::size(keys)) {
+        slots <<= 1;
+    }
+    auto occupied = std::vector<bool>(slots);
+    auto collisions = std::size_t{0};
+    for (auto const key: keys) {
+        auto const i = slot(key) & (slots - 1);
+        collisions += occupied[i];
+        occupied[i] = true;
+    }
+    return collisions;
+}
+
+template <typename Hash>
+auto measure(std::string const& name, Trace const& trace, Hash hash) -> void {
+    auto keys = std::vector<std::size_t>(std::size(trace.objects));
+    std::transform(std::begin(trace.objects), std::end(trace.objects), std::begin(keys), hash);
+
+    auto sorted = keys;
+    std::sort(std::begin(sorted), std::end(sorted));
+    auto const distinct = static_cast<std::size_t>(std::unique(std::begin(sorted), std::end(sorted)) - std::begin(sorted));
+    auto const collisions = std::size(keys) - distinct;
+    auto const raw = slot_collisions(keys, RawKeyHash{});
+    auto const mixed = slot_collisions(keys, pathways::key_hash<std::size_t>{});
+
+    auto sink = std::size_t{0};
+    auto start = high_resolution_clock::now();
+    for (auto const id: trace.hashed) {
+        sink += hash(trace.objects[id]);
+    }
+    duration<double, std::nano> elapsed = high_resolution_clock::now() - start;
+    if (sink == 42) {
+        std::cerr << "";
+    }
+
+    auto const results = {
+        replay<Flat>(trace, keys),
+        replay<RawFlat>(trace, keys),
+        replay<Flat>(trace, keys, 0.75f),
+        replay<Compact>(trace, keys),
+    };
+    auto const layouts = { "flat", "flat (raw)", "flat (0.75)", "compact" };
+
+    auto const ns = std::to_string(elapsed.count() / std::size(trace.hashed));
+    auto first = true;
+    auto layout = std::begin(layouts);
+    for (auto const& result: results) {
+        std::cout << std::setw(12) << (first ? name : "")
+                  << std::setw(12) << (first ? std::to_string(collisions) : "")
+                  << std::setw(12) << (first ? std::to_string(raw) : "")
+                  << std::setw(12) << (first ? std::to_string(mixed) : "")
+                  << std::setw(12) << (first ? ns.substr(0, ns.find('.') + 3) : "")
+                  << std::setw(14) << *layout
+                  << std::setw(12) << std::setprecision(3) << result.mean_probe
+                  << std::setw(12) << result.long_probes
+                  << std::setw(12) << result.rate / 1e6 << std::setprecision(6) << std::endl;
+        first = false;
+        ++layout;
+    }
+}
+
+auto report(std::string const& workload, std::vector<std::string> const& strs) -> void {
+    auto const trace = record(strs);
+    std::cout << workload << ": " << std::size(strs) << " strings, "
+              << std::size(trace.objects) << " distinct objects, "
+              << std::size(trace.hashed) << " hashes, "
+              << std::size(trace.ops) << " cache operations\n\n"
+              << std::setw(12) << "hash"
+              << std::setw(12) << "collisions"
+              << std::setw(12) << "raw slots"
+              << std::setw(12) << "mixed slots"
+              << std::setw(12) << "ns/hash"
+              << std::setw(14) << "layout"
+              << std::setw(12) << "mean probe"
+              << std::setw(12) << "probes 15+"
+              << std::setw(12) << "Mops/s" << std::endl;
+    measure("std", trace, std::hash<std::string>{});
+    measure("simd", trace, pathways::StringHash{});
+    measure("polynomial", trace, Polynomial{});
+    measure("fnv1a", trace, Fnv1a{});
+    std::cout << std::endl;
+}
+
+auto main(int argc, char **argv) -> int {
+    auto seed = std::random_device{}();
+    auto n = std::size_t{5};
+    auto length = std::size_t{100};
+    auto corpus = std::string{"perf/data/str_sa.csv"};
+    auto strs = std::vector<std::string>{};
+    try {
+        Flags{}.add("-s", "seed", seed).add("-n", "samples", n).add("-l", "length", length).add("-c", "corpus.csv", corpus).parse(argc, argv);
+        strs = read_strings(corpus);
+    } catch (std::string &s) {
+        std::cerr << s << std::endl;
+        return 1;
+    } catch (std::runtime_error const& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    report(corpus, strs);
+
+    std::mt19937 gen(seed);
+    auto random = std::vector<std::string>(n);
+    std::generate(std::begin(random), std::end(random), [&]() { return random_string(length, gen); });
+    report("random_string(" + std::to_string(length) + ")", random);
+}
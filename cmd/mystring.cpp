@@ -1,10 +1,11 @@
 #include "random.h"
 #include <iostream>
+#include <pathways/hashcons.h>
 #include <pathways/pathways.h>
 
 class MyString {
     private:
-        std::string const str;
+        std::string str;
 
         friend struct std::hash<MyString>;
     public:
@@ -33,6 +34,10 @@ class MyString {
             }
             return parts;
         }
+
+        friend auto operator==(MyString const& x, MyString const& y) -> bool {
+            return x.str == y.str;
+        }
 };
 
 namespace std {
@@ -43,12 +48,29 @@ namespace std {
     };
 }
 
-auto main() -> int {
+auto main(int argc, char **argv) -> int {
+    auto const consed = argc == 2 && std::string(argv[1]) == "--consed";
+    if (argc > 1 && !consed) {
+        std::cerr << "usage: " << argv[0] << " [--consed]" << std::endl;
+        return 1;
+    }
+
     std::random_device rd;
     std::mt19937 gen(rd());
 
     auto const str = random_string(200, gen);
-    pathways::Context<MyString> ctx;
-    std::cout << "c ~ " << ctx.assembly_index(str) << std::endl;
-    std::cout << "Cache size: " << ctx.cache_size() << std::endl;
+    if (consed) {
+        // Hash-cons the strings, so that each distinct substring is stored
+        // (and hashed) once and the contexts cache on dense handles.
+        pathways::ObjectStore<MyString> store;
+        using Handle = pathways::Consed<MyString>;
+        pathways::Context<Handle, pathways::disassembly_type<Handle>::value, pathways::DenseCache> ctx;
+        std::cout << "c ~ " << ctx.assembly_index(store.intern(str)) << std::endl;
+        std::cout << "Cache size: " << ctx.cache_size() << std::endl;
+        std::cout << "Objects stored: " << store.size() << std::endl;
+    } else {
+        pathways::Context<MyString> ctx;
+        std::cout << "c ~ " << ctx.assembly_index(str) << std::endl;
+        std::cout << "Cache size: " << ctx.cache_size() << std::endl;
+    }
 }
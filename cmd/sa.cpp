@@ -1,52 +1,156 @@
 #include "random.h"
 #include <iostream>
+#include <pathways/binary.h>
+#include <pathways/hash.h>
+#include <pathways/intern.h>
+#include <pathways/packed.h>
 #include <pathways/string.h>
+#include <pathways/string_view.h>
+#include <pathways/substring.h>
 #include <chrono>
 #include <sstream>
+#include <type_traits>
 
 using namespace std::chrono;
 
+struct Options {
+    std::string str;
+    bool cache = true;
+    bool stats = false;
+    bool substring = false;
+    bool fingerprint = false;
+    bool audit = false;
+    bool intern = false;
+    bool binary = false;
+    bool view = false;
+    bool packed = false;
+};
+
 auto usage(char *cmd) -> void {
     std::stringstream ss;
-    ss << "usage: " << cmd << " [--no-cache] <string>";
+    ss << "usage: " << cmd << " [--no-cache] [--stats] [--substring] [--fingerprint] [--audit] [--intern] [--binary] [--view] [--packed] <string>";
     throw ss.str();
 }
 
-auto args(int argc, char **argv) -> std::tuple<std::string, bool> {
+auto args(int argc, char **argv) -> Options {
     if (argc == 1) {
 	usage(argv[0]);
     }
-    auto str = std::string{};
-    auto cache = true;
+    auto options = Options{};
     for (auto i = 1; i < argc; ++i) {
         auto arg = std::string(argv[i]);
         if (arg == "--no-cache") {
-            cache = false;
-        } else if (str == "") {
-            str = arg;
+            options.cache = false;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--substring") {
+            options.substring = true;
+        } else if (arg == "--fingerprint") {
+            options.fingerprint = true;
+        } else if (arg == "--audit") {
+            options.audit = true;
+        } else if (arg == "--intern") {
+            options.intern = true;
+        } else if (arg == "--binary") {
+            options.binary = true;
+        } else if (arg == "--view") {
+            options.view = true;
+        } else if (arg == "--packed") {
+            options.packed = true;
+        } else if (options.str == "") {
+            options.str = arg;
         } else {
             usage(argv[0]);
         }
     }
-    return { str, cache };
+    return options;
+}
+
+template <typename Hash>
+struct is_audited : std::false_type {};
+
+template <typename T, typename Hash>
+struct is_audited<pathways::Audited<T, Hash>> : std::true_type {};
+
+// Compute and report the assembly index of `options.str`, represented as a `T`,
+// hashed with a `Hash` and cached according to a `CachePolicy`.
+template <typename T, typename Hash, template <typename, typename> class CachePolicy>
+auto measure(Options const& options) -> void {
+    pathways::Context<T, typename pathways::disassembly_type<T>::value, CachePolicy, Hash> ctx;
+
+    auto start = high_resolution_clock::now();
+    auto const c = ctx.assembly_index(T{options.str}, options.cache);
+    auto stop = high_resolution_clock::now();
+    std::cout << c << std::endl;
+    duration<double> elapsed = stop - start;
+    std::cout << elapsed.count() << std::endl;
+    if (options.stats) {
+        if (pathways::collect_statistics) {
+            std::cout << ctx.statistics() << std::endl;
+        } else {
+            std::cerr << "statistics are not collected; rebuild with `make STATS=1`" << std::endl;
+        }
+    }
+    if constexpr (is_audited<Hash>::value) {
+        std::cout << "objects hashed:    " << ctx.hasher().objects() << '\n'
+                  << "collisions:        " << ctx.hasher().collisions() << std::endl;
+    }
+}
+
+template <typename T, typename Hash, template <typename, typename> class CachePolicy = pathways::FlatCache>
+auto run(Options const& options) -> void {
+    if (options.audit) {
+        measure<T, pathways::Audited<T, Hash>, CachePolicy>(options);
+    } else {
+        measure<T, Hash, CachePolicy>(options);
+    }
+}
+
+template <typename T>
+auto run(Options const& options) -> void {
+    if (options.fingerprint) {
+        run<T, pathways::FingerprintHash<T>>(options);
+    } else {
+        run<T, typename pathways::default_hash<T>::type>(options);
+    }
 }
 
 auto main(int argc, char **argv) -> int {
-    auto str = std::string{};
-    auto cache = false;
+    auto options = Options{};
     try {
-        std::tie(str, cache) = args(argc, argv);
+        options = args(argc, argv);
     } catch (std::string &s) {
         std::cerr << s << std::endl;
         return 1;
     }
 
-    pathways::Context<std::string> ctx;
+    if (options.intern + options.binary + options.substring + options.view + options.packed > 1 || ((options.intern || options.binary || options.view || options.packed) && options.fingerprint)) {
+        std::cerr << "--intern, --binary, --substring, --view and --packed are exclusive, and only --substring can be combined with --fingerprint" << std::endl;
+        return 1;
+    }
 
-    auto start = high_resolution_clock::now();
-    auto const c = ctx.assembly_index(str, cache);
-    auto stop = high_resolution_clock::now();
-    std::cout << c << std::endl;
-    duration<double> elapsed = stop - start;
-    std::cout << elapsed.count() << std::endl;
+    using PackedBinary = pathways::PackedString<pathways::BinaryAlphabet>;
+    using PackedQuaternary = pathways::PackedString<pathways::QuaternaryAlphabet>;
+    if (options.packed && !PackedBinary::encodes(options.str) && !PackedQuaternary::encodes(options.str)) {
+        std::cerr << "--packed strings must be written in 0 and 1, or in A through D" << std::endl;
+        return 1;
+    }
+
+    if (options.intern) {
+        run<pathways::InternedString, std::hash<pathways::InternedString>, pathways::DenseCache>(options);
+    } else if (options.binary) {
+        run<std::string, pathways::BinaryHash, pathways::BinaryCache>(options);
+    } else if (options.view) {
+        run<std::string_view, pathways::PolynomialHash>(options);
+    } else if (options.packed) {
+        if (PackedBinary::encodes(options.str)) {
+            run<PackedBinary, std::hash<PackedBinary>>(options);
+        } else {
+            run<PackedQuaternary, std::hash<PackedQuaternary>>(options);
+        }
+    } else if (options.substring) {
+        run<pathways::Substring>(options);
+    } else {
+        run<std::string>(options);
+    }
 }
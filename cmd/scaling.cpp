@@ -1,7 +1,9 @@
 #include "args.h"
 #include "random.h"
+#include "sweep.h"
 #include <mgl2/mgl.h>
 #include <pathways/string.h>
+#include <tuple>
 
 auto statistics(std::vector<double> data) {
     double const N = std::size(data);
@@ -18,12 +20,12 @@ auto statistics(std::vector<double> data) {
 }
 
 template <typename Generator>
-auto assembly_index(Generator &gen, std::size_t len, std::size_t n, double p) {
-    pathways::Context<std::string> ctx;
+auto assembly_index(Sweep &sweep, Generator &gen, std::size_t len, std::size_t n, double p) {
+    sweep.batch();
     auto data = std::vector<double>(n);
     for (std::size_t i = 0; i < n; ++i) {
         auto const str = random_string(len, gen, p);
-        data[i] = ctx.assembly_index(str);
+        data[i] = sweep.assembly_index(str);
     }
     return statistics(std::move(data));
 }
@@ -73,7 +75,7 @@ auto plot(mglGraph &gr, PlotData const& data) -> mglGraph& {
 }
 
 template <typename Generator>
-auto length_scaling(mglGraph &gr, Generator &gen, size_t min_len, size_t max_len, size_t num_str, double p) -> mglGraph& {
+auto length_scaling(mglGraph &gr, Sweep &sweep, Generator &gen, size_t min_len, size_t max_len, size_t num_str, double p) -> mglGraph& {
     auto data = PlotData{
         static_cast<long>(max_len - min_len + 1),
         "Length Scaling",
@@ -84,14 +86,14 @@ auto length_scaling(mglGraph &gr, Generator &gen, size_t min_len, size_t max_len
 
     for (std::size_t len = min_len, i = 0; len <= max_len; ++len, ++i) {
         data.x.a[i] = static_cast<double>(len);
-        std::tie(data.y.a[i], data.err.a[i]) = assembly_index(gen, len, num_str, p);
+        std::tie(data.y.a[i], data.err.a[i]) = assembly_index(sweep, gen, len, num_str, p);
     }
 
     return plot(gr, data);
 }
 
 template <typename Generator>
-auto prob_scaling(mglGraph &gr, Generator &gen, size_t len, size_t num_str, double p_step) -> mglGraph& {
+auto prob_scaling(mglGraph &gr, Sweep &sweep, Generator &gen, size_t len, size_t num_str, double p_step) -> mglGraph& {
     std::size_t const n_step = 1 + std::floor(1 / p_step);
     auto data = PlotData{
         static_cast<long>(n_step),
@@ -104,7 +106,7 @@ auto prob_scaling(mglGraph &gr, Generator &gen, size_t len, size_t num_str, doub
     double p = 0.0;
     for (std::size_t i = 0; i < n_step; ++i, p += p_step) {
         data.x.a[i] = p;
-        std::tie(data.y.a[i], data.err.a[i]) = assembly_index(gen, len, num_str, p);
+        std::tie(data.y.a[i], data.err.a[i]) = assembly_index(sweep, gen, len, num_str, p);
     }
 
     return plot(gr, data);
@@ -115,14 +117,18 @@ auto main(int argc, char **argv) -> int {
 
     std::mt19937 gen(args.seed);
 
+    Sweep sweep{args.cache_limit, args.compare};
+
     mglGraph gr;
     gr.SetSize(800, 1200);
 
     gr.SubPlot(1, 2, 0);
-    length_scaling(gr, gen, 10, 50, args.n, 0.5);
+    length_scaling(gr, sweep, gen, 10, 50, args.n, 0.5);
 
     gr.SubPlot(1, 2, 1);
-    prob_scaling(gr, gen, 50, args.n, 0.01);
+    prob_scaling(gr, sweep, gen, 50, args.n, 0.01);
 
     gr.WriteFrame(args.filename.c_str());
+
+    sweep.report(std::cout);
 }
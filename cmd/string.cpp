@@ -2,7 +2,13 @@
 #include <iostream>
 #include <pathways/string.h>
 
-auto main() -> int {
+auto main(int argc, char **argv) -> int {
+    auto const stats = argc == 2 && std::string(argv[1]) == "--stats";
+    if (argc > 1 && !stats) {
+        std::cerr << "usage: " << argv[0] << " [--stats]" << std::endl;
+        return 1;
+    }
+
     std::random_device rd;
     std::mt19937 gen(rd());
 
@@ -10,4 +16,11 @@ auto main() -> int {
     pathways::Context<std::string> ctx;
     std::cout << "c ~ " << ctx.assembly_index(str) << std::endl;
     std::cout << "Cache size: " << ctx.cache_size() << std::endl;
+    if (stats) {
+        if (pathways::collect_statistics) {
+            std::cout << ctx.statistics() << std::endl;
+        } else {
+            std::cerr << "statistics are not collected; rebuild with `make STATS=1`" << std::endl;
+        }
+    }
 }
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <pathways/string.h>
+#include <string>
+#include <variant>
+#include <vector>
+
+// A `Sweep` computes the assembly index of every string in a parameter sweep
+// within a single, long-lived context. Random strings share a huge number of
+// short substrings, so the assembly indices cached for one string are reused
+// by all that follow. The coassembly indices, on the other hand, are almost
+// never reused across strings and only bloat the cache — sharing them makes a
+// sweep slower than using a fresh context per string — so they are dropped
+// once each string is done.
+//
+// The shared cache is optionally capped at `cache_limit` bytes — a quarter of
+// which goes to the assembly indices and the rest to the far more numerous
+// coassembly indices. If `compare` is set, the strings are recorded in the
+// batches the sweep was run in, so that `report` can recompute them with a
+// fresh context per batch and print how much time the shared cache saved.
+class Sweep {
+    private:
+        using Unbounded = pathways::Context<std::string>;
+        using Bounded = pathways::BoundedContext<std::string>;
+
+        std::variant<Unbounded, Bounded> ctx;
+        bool compare;
+        std::vector<std::vector<std::string>> batches;
+        std::chrono::duration<double> elapsed{0};
+
+        static auto context(std::size_t cache_limit) -> std::variant<Unbounded, Bounded> {
+            if (cache_limit == 0) {
+                return Unbounded{};
+            }
+            return Bounded{
+                Bounded::assembly_cache_type::with_memory(cache_limit / 4, 3),
+                Bounded::coassembly_cache_type::with_memory(cache_limit - cache_limit / 4)
+            };
+        }
+
+    public:
+        explicit Sweep(std::size_t cache_limit = 0, bool compare = false):
+            ctx{context(cache_limit)}, compare{compare}, batches{1} {
+            std::visit([](auto &ctx) { ctx.retention(pathways::Retention::assembly_only()); }, this->ctx);
+        }
+
+        // Start a new batch of strings. Before strings were swept through a shared
+        // cache, each batch was computed in its own context.
+        auto batch() -> void {
+            if (this->compare && !this->batches.back().empty()) {
+                this->batches.emplace_back();
+            }
+        }
+
+        auto assembly_index(std::string const& str) -> uint32_t {
+            if (this->compare) {
+                this->batches.back().push_back(str);
+            }
+            auto const start = std::chrono::high_resolution_clock::now();
+            auto const c = std::visit([&str](auto &ctx) { return ctx.assembly_index(str); }, this->ctx);
+            this->elapsed += std::chrono::high_resolution_clock::now() - start;
+            return c;
+        }
+
+        auto report(std::ostream &out) const -> void {
+            auto const [size, evictions] = std::visit([](auto const& ctx) {
+                return std::make_pair(ctx.cache_size(), ctx.cache_evictions());
+            }, this->ctx);
+
+            out << "shared cache: " << this->elapsed.count() << "s, "
+                << size << " entries, " << evictions << " evictions" << std::endl;
+
+            if (this->compare) {
+                auto separate = std::chrono::duration<double>{0};
+                for (auto const& batch: this->batches) {
+                    pathways::Context<std::string> ctx;
+                    auto const start = std::chrono::high_resolution_clock::now();
+                    for (auto const& str: batch) {
+                        ctx.assembly_index(str);
+                    }
+                    separate += std::chrono::high_resolution_clock::now() - start;
+                }
+                auto const saved = separate - this->elapsed;
+                out << "per-batch contexts: " << separate.count() << "s over "
+                    << std::size(this->batches) << " batches" << '\n'
+                    << "saved: " << saved.count() << "s ("
+                    << 100 * saved.count() / separate.count() << "%)" << std::endl;
+            }
+        }
+};
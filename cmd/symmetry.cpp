@@ -0,0 +1,90 @@
+#include "args.h"
+#include <iostream>
+#include <pathways/pathways.h>
+#include <set>
+#include <string>
+#include <vector>
+
+// Every pair of components produced by a disassembly is looked up in the
+// coassembly cache in the order in which it was produced. The `TracedString`
+// type records each of those (non-basic) pairs, so that we can count how many
+// coassembly indices would be computed if the cache were keyed on ordered
+// pairs of hashes rather than on canonically ordered ones.
+class TracedString {
+    private:
+        std::string str;
+
+        friend struct std::hash<TracedString>;
+
+    public:
+        using disassembly_type = std::vector<pathways::Components<TracedString>>;
+
+        static std::set<std::pair<std::size_t, std::size_t>> pairs;
+
+        TracedString(std::string str): str{std::move(str)} {
+            if (this->str.empty()) {
+                throw std::invalid_argument("string is empty");
+            }
+        }
+
+        auto is_basic() const -> bool {
+            return std::size(this->str) == 1;
+        }
+
+        auto is_below(TracedString const& other) const -> bool {
+            return other.str.find(this->str) != std::string::npos;
+        }
+
+        auto disassemble() const -> disassembly_type {
+            auto parts = disassembly_type{};
+            for (std::size_t i = 1, len = std::size(str); i < len; ++i) {
+                parts.emplace_back(str.substr(0, i), str.substr(i));
+                auto const& [x, y] = parts.back();
+                if (!x.is_basic() && !y.is_basic()) {
+                    auto const hash = std::hash<std::string>{};
+                    pairs.emplace(hash(x.str), hash(y.str));
+                }
+            }
+            return parts;
+        }
+};
+
+std::set<std::pair<std::size_t, std::size_t>> TracedString::pairs = {};
+
+namespace std {
+    template <> struct hash<TracedString> {
+        auto operator()(TracedString const& arg) const noexcept -> std::size_t {
+            return std::hash<std::string>{}(arg.str);
+        }
+    };
+}
+
+auto main(int argc, char **argv) -> int {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <csv file>" << std::endl;
+        return 1;
+    }
+
+    auto strs = std::vector<std::string>{};
+    try {
+        strs = read_strings(argv[1]);
+    } catch (std::runtime_error const& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    auto ordered = std::size_t{0};
+    auto canonical = std::size_t{0};
+    for (auto const& str: strs) {
+        TracedString::pairs.clear();
+        pathways::Context<TracedString> ctx;
+        ctx.assembly_index(str);
+        ordered += std::size(TracedString::pairs);
+        canonical += ctx.coassembly_cache_size();
+    }
+
+    std::cout << "strings:                   " << std::size(strs) << '\n'
+              << "ordered pair computations: " << ordered << '\n'
+              << "canonical pair entries:    " << canonical << '\n'
+              << "duplicates removed:        " << ordered - canonical << std::endl;
+}
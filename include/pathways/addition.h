@@ -1,17 +1,87 @@
 #pragma once
 
 #include "pathways.h"
+#include <cstddef>
+#include <iterator>
 #include <stdexcept>
-#include <vector>
 
 namespace pathways {
+    // An `IntDisassembly` lazily yields the pairs `(left, n - left)` for
+    // `left` from 1 up to `n / 2`, so that each unordered pair of positive
+    // integers summing to `n` appears once.
+    class IntDisassembly {
+        private:
+            int _n;
+
+        public:
+            class const_iterator {
+                private:
+                    int _n;
+                    int _left;
+
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = Components<int>;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = value_type;
+
+                    const_iterator(int n, int left) noexcept: _n{n}, _left{left} {}
+
+                    auto operator++() noexcept -> const_iterator& {
+                        ++this->_left;
+                        return *this;
+                    }
+
+                    auto operator++(int) noexcept -> const_iterator {
+                        auto temp = *this;
+                        ++this->_left;
+                        return temp;
+                    }
+
+                    auto operator*() const noexcept -> value_type {
+                        return { this->_left, this->_n - this->_left };
+                    }
+
+                    auto operator==(const_iterator const& other) const noexcept -> bool {
+                        return this->_left == other._left;
+                    }
+
+                    auto operator!=(const_iterator const& other) const noexcept -> bool {
+                        return !(*this == other);
+                    }
+            };
+
+            explicit IntDisassembly(int n): _n{n} {
+                if (n < 1) {
+                    throw std::invalid_argument("integers less than 1 are not in the space");
+                }
+            }
+
+            auto begin() const noexcept -> const_iterator {
+                return const_iterator(this->_n, 1);
+            }
+
+            auto end() const noexcept -> const_iterator {
+                return const_iterator(this->_n, this->_n / 2 + 1);
+            }
+
+            auto size() const noexcept -> std::size_t {
+                return static_cast<std::size_t>(this->_n / 2);
+            }
+
+            auto empty() const noexcept -> bool {
+                return this->_n == 1;
+            }
+    };
+
     template <>
     struct disassembly_type<int> {
-        using value = std::vector<Components<int>>;
+        using value = IntDisassembly;
     };
 
     template <>
-    auto is_basic<int>(int const& x) -> bool {
+    inline auto is_basic<int>(int const& x) -> bool {
         if (x < 1) {
             throw std::invalid_argument("integers less than 1 are not in the space");
         }
@@ -19,7 +89,7 @@ namespace pathways {
     }
 
     template <>
-    auto is_below<int>(int const& x, int const& y) -> bool {
+    inline auto is_below<int>(int const& x, int const& y) -> bool {
         if (x < 1 || y < 1) {
             throw std::invalid_argument("integers less than 1 are not in the space");
         }
@@ -27,17 +97,8 @@ namespace pathways {
     }
 
     template <>
-    auto disassemble<int>(int const& n) -> std::vector<Components<int>> {
-        if (n < 1) {
-            throw std::invalid_argument("integers less than 1 are not in the space");
-        }
-        auto parts = std::vector<Components<int>>{};
-        if (n != 1) {
-            for (int left = 1; left <= (n - (n & 1)) / 2; ++left) {
-                parts.emplace_back(left, n - left);
-            }
-        }
-        return parts;
+    inline auto disassemble<int>(int const& n) -> IntDisassembly {
+        return IntDisassembly(n);
     }
 
     template class Context<int>;
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "cache.h"
+#include "simd.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pathways {
+
+// Binary strings (e.g. those made by `random_string`) of up to
+// `short_binary_length` characters have a small, dense encoding: their bits
+// below a single sentinel bit marking their length, so that `"01"` is `0b101`
+// and `"001"` is `0b1001`. Every such string has a code below
+// `binary_code_limit`.
+constexpr std::size_t short_binary_length = 20;
+constexpr std::size_t binary_code_limit = std::size_t{1} << (short_binary_length + 1);
+
+// Get the code of a short binary string. The `binary_code_limit` is returned
+// if the string is too long or has characters other than `'0'` and `'1'`.
+inline auto binary_code(std::string_view str) noexcept -> std::size_t {
+    if (std::size(str) > short_binary_length) {
+        return binary_code_limit;
+    }
+    auto code = std::size_t{1};
+    for (auto const c: str) {
+        auto const bit = static_cast<std::size_t>(static_cast<unsigned char>(c) - '0');
+        if (bit > 1) {
+            return binary_code_limit;
+        }
+        code = (code << 1) | bit;
+    }
+    return code;
+}
+
+// The `BinaryHash` hasher keys short binary strings on their code, and every
+// other string on its `simd_hash` with the top bit set, so that the two never
+// overlap. It is meant to be paired with the `BinaryCache` policy:
+//
+// ```cpp
+// Context<std::string, disassembly_type<std::string>::value, BinaryCache, BinaryHash> ctx;
+// ```
+struct BinaryHash {
+    static constexpr std::size_t tag = std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1);
+
+    auto operator()(std::string const& str) const noexcept -> std::size_t {
+        auto const code = binary_code(str);
+        if (code < binary_code_limit) {
+            return code;
+        }
+        return static_cast<std::size_t>(simd_hash(str)) | tag;
+    }
+};
+
+// The `BinaryCache<Key, Store>` policy is a two-tier cache for keys made by a
+// `BinaryHash`. The assembly indices of short binary strings live in a flat
+// array indexed directly by their code, so looking one up is a single load
+// with no hashing and no probing. Every other key goes to a `FlatCache`.
+//
+// An assembly index of a string of `n` characters is less than `n`, so the
+// direct tier stores one byte per entry, with `0xff` marking empty entries;
+// it takes `binary_code_limit` bytes (2 MiB) once something is stored in it.
+template <typename Key, typename Store>
+class BinaryCache {
+    static_assert(std::is_same_v<Key, std::size_t>, "BinaryCache keys must come from a BinaryHash");
+
+    private:
+        static constexpr std::uint8_t empty = 0xff;
+
+        std::vector<std::uint8_t> _direct;
+        std::size_t _direct_size = 0;
+        FlatCache<Key, Store> _general;
+
+    public:
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (key < binary_code_limit) {
+                if (!this->_direct.empty() && this->_direct[key] != empty) {
+                    return static_cast<Store>(this->_direct[key]);
+                }
+                return {};
+            }
+            return this->_general.find(key);
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            if (key < binary_code_limit && store < empty) {
+                if (this->_direct.empty()) {
+                    this->_direct.resize(binary_code_limit, empty);
+                }
+                this->_direct_size += (this->_direct[key] == empty);
+                this->_direct[key] = static_cast<std::uint8_t>(store);
+                return store;
+            }
+            return this->_general.insert(key, store);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_direct_size + this->_general.size();
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_direct) + this->_general.capacity();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_direct) + this->_general.bytes();
+        }
+
+        // Only the general tier is ever probed.
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_general.probe_lengths();
+        }
+
+        auto clear() noexcept -> void {
+            std::fill(std::begin(this->_direct), std::end(this->_direct), empty);
+            this->_direct_size = 0;
+            this->_general.clear();
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const size = this->_direct_size;
+            for (std::size_t key = 0; key < std::size(this->_direct); ++key) {
+                auto& value = this->_direct[key];
+                if (value != empty && pred(static_cast<Key>(key), static_cast<Store>(value))) {
+                    value = empty;
+                    --this->_direct_size;
+                }
+            }
+            return (size - this->_direct_size) + this->_general.erase_if(pred);
+        }
+
+        // The direct tier never grows, so only the general tier is reserved.
+        auto reserve(std::size_t n) -> void {
+            this->_general.reserve(n);
+        }
+};
+
+// Pairs of short binary strings whose combined length is at most
+// `short_binary_pair_length` are stored directly as well. The pair `(x, y)` is
+// indexed by the code of the concatenation `xy` and the length of `x`, which
+// together determine both strings.
+constexpr std::size_t short_binary_pair_length = 16;
+
+template <typename Store>
+class BinaryCache<std::pair<std::size_t, std::size_t>, Store> {
+    public:
+        using key_type = std::pair<std::size_t, std::size_t>;
+
+    private:
+        static constexpr std::uint8_t empty = 0xff;
+        static constexpr std::size_t split_bits = 4;
+        static constexpr std::size_t limit = std::size_t{1} << (short_binary_pair_length + 1 + split_bits);
+
+        std::vector<std::uint8_t> _direct;
+        std::size_t _direct_size = 0;
+        FlatCache<key_type, Store> _general;
+
+        // Get the number of characters in the string with a given code.
+        static auto length(std::size_t code) noexcept -> std::size_t {
+            return static_cast<std::size_t>(std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(code));
+        }
+
+        // Get the index of a pair in the direct tier, or `limit` if the pair
+        // belongs in the general tier. Keys below 2 aren't the codes of
+        // non-empty strings, so they go to the general tier too.
+        static auto index(key_type const& key) noexcept -> std::size_t {
+            auto const [x, y] = key;
+            if (x >= binary_code_limit || y >= binary_code_limit || x < 2 || y < 2) {
+                return limit;
+            }
+            auto const x_length = length(x);
+            auto const y_length = length(y);
+            if (x_length + y_length > short_binary_pair_length) {
+                return limit;
+            }
+            auto const joined = (x << y_length) | (y ^ (std::size_t{1} << y_length));
+            return (joined << split_bits) | (x_length - 1);
+        }
+
+        static auto unindex(std::size_t i) noexcept -> key_type {
+            auto const x_length = (i & ((std::size_t{1} << split_bits) - 1)) + 1;
+            auto const joined = i >> split_bits;
+            auto const y_length = length(joined) - x_length;
+            auto const y_bits = joined & ((std::size_t{1} << y_length) - 1);
+            return { joined >> y_length, y_bits | (std::size_t{1} << y_length) };
+        }
+
+    public:
+        auto find(key_type const& key) const noexcept -> std::optional<Store> {
+            auto const i = index(key);
+            if (i < limit) {
+                if (!this->_direct.empty() && this->_direct[i] != empty) {
+                    return static_cast<Store>(this->_direct[i]);
+                }
+                return {};
+            }
+            return this->_general.find(key);
+        }
+
+        auto insert(key_type const& key, Store store) -> Store {
+            auto const i = index(key);
+            if (i < limit && store < empty) {
+                if (this->_direct.empty()) {
+                    this->_direct.resize(limit, empty);
+                }
+                this->_direct_size += (this->_direct[i] == empty);
+                this->_direct[i] = static_cast<std::uint8_t>(store);
+                return store;
+            }
+            return this->_general.insert(key, store);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_direct_size + this->_general.size();
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_direct) + this->_general.capacity();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_direct) + this->_general.bytes();
+        }
+
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_general.probe_lengths();
+        }
+
+        auto clear() noexcept -> void {
+            std::fill(std::begin(this->_direct), std::end(this->_direct), empty);
+            this->_direct_size = 0;
+            this->_general.clear();
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const size = this->_direct_size;
+            for (std::size_t i = 0; i < std::size(this->_direct); ++i) {
+                auto& value = this->_direct[i];
+                if (value != empty && pred(unindex(i), static_cast<Store>(value))) {
+                    value = empty;
+                    --this->_direct_size;
+                }
+            }
+            return (size - this->_direct_size) + this->_general.erase_if(pred);
+        }
+
+        auto reserve(std::size_t n) -> void {
+            this->_general.reserve(n);
+        }
+};
+
+}
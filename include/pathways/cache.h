@@ -0,0 +1,1086 @@
+#pragma once
+
+#include "statistics.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace pathways {
+
+// A `CachePolicy` is a class template `Policy<Key, Store>` which maps keys
+// (object hashes, or pairs thereof) to stored values (e.g. assembly indices).
+// `Context` instantiates its policy with the key and value types it needs and
+// calls it directly, so there is no virtual dispatch on the hot path. A policy
+// must be default constructible, movable and provide
+//
+// ```cpp
+// auto find(Key const& key) const -> std::optional<Store>;
+// auto insert(Key const& key, Store store) -> Store;
+// auto size() const -> std::size_t;
+// auto capacity() const -> std::size_t;
+// auto evictions() const -> std::size_t;
+// auto bytes() const -> std::size_t;
+// auto probe_lengths() const -> ProbeHistogram;
+// auto clear() -> void;
+// template <typename Predicate>
+// auto erase_if(Predicate pred) -> std::size_t;
+// auto reserve(std::size_t n) -> void;
+// ```
+//
+// where `insert` overwrites any existing value and returns the stored value,
+// `evictions` counts the entries a bounded policy has dropped to make room
+// for others (always zero for unbounded policies), `bytes` estimates the
+// memory the policy has allocated, `probe_lengths` is a histogram of how far
+// lookups probed (only populated when statistics are collected; see
+// `statistics.h`), `erase_if` removes every entry for which `pred(key, value)`
+// is true and returns the number removed, and `reserve` is a hint which a
+// policy is free to ignore.
+
+// The keys stored in a cache are (pairs of) object hashes, so they are
+// already "random" in some sense. However, we can't rely on their low bits
+// being well distributed — `std::hash<int>`, for example, is the identity
+// function. The `mix` function is the finalizer from splitmix64 and is used to
+// scatter keys across the slots of an open-addressing table.
+inline auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// The `key_hash<Key>` type computes the slot hash of a cache key. It is
+// specialized for single hashes and pairs of hashes, but can be specialized
+// for any other key type you'd like to cache on.
+template <typename Key>
+struct key_hash;
+
+template <>
+struct key_hash<std::size_t> {
+    auto operator()(std::size_t key) const noexcept -> std::size_t {
+        return mix(key);
+    }
+};
+
+template <typename First, typename Second>
+struct key_hash<std::pair<First, Second>> {
+    auto operator()(std::pair<First, Second> const& key) const noexcept -> std::size_t {
+        return mix(key_hash<First>{}(key.first) ^ mix(key_hash<Second>{}(key.second)));
+    }
+};
+
+// The `FlatCache<Key, Store>` is an open-addressing hash table specialized for
+// the access pattern of the assembly algorithms: lots of lookups and inserts,
+// no erasures. Keys and values are stored contiguously in a single array of
+// slots whose length is always a power of two, and collisions are resolved by
+// linear probing. The table doubles in size whenever an insertion would push
+// the load factor above `max_load_factor()`.
+//
+// If you have a rough idea of how many entries you'll be storing, call
+// `reserve` up front to avoid rehashing as the table grows.
+template <typename Key, typename Store, typename Hash = key_hash<Key>>
+class FlatCache {
+    private:
+        struct Slot {
+            Key key;
+            Store value;
+            bool occupied;
+        };
+
+        std::vector<Slot> _slots;
+        std::size_t _size = 0;
+        float _max_load_factor = 0.5f;
+        mutable ProbeHistogram _probes;
+
+        // Find the slot index at which `key` either resides or would be
+        // inserted. The table must have at least one empty slot.
+        auto probe(Key const& key) const noexcept -> std::size_t {
+            auto const mask = std::size(this->_slots) - 1;
+            auto i = Hash{}(key) & mask;
+            while (this->_slots[i].occupied && !(this->_slots[i].key == key)) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        // Record how far from its home slot `key` was found (or placed) at slot
+        // `i`, if statistics are being collected.
+        auto record(Key const& key, std::size_t i) const noexcept -> void {
+            if constexpr (collect_statistics) {
+                auto const mask = std::size(this->_slots) - 1;
+                this->_probes.record((i - (Hash{}(key) & mask)) & mask);
+            }
+        }
+
+        // Rebuild the table with `capacity` slots, reinserting every entry.
+        auto rehash(std::size_t capacity) -> void {
+            auto slots = std::vector<Slot>(capacity);
+            std::swap(slots, this->_slots);
+            for (auto const& slot: slots) {
+                if (slot.occupied) {
+                    this->_slots[this->probe(slot.key)] = slot;
+                }
+            }
+        }
+
+        // The smallest power-of-two number of slots which can hold `n`
+        // entries without exceeding the maximum load factor.
+        auto slots_for(std::size_t n) const noexcept -> std::size_t {
+            auto capacity = std::size_t{8};
+            while (static_cast<float>(n) > this->_max_load_factor * capacity) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+    public:
+        FlatCache() = default;
+
+        explicit FlatCache(std::size_t n) {
+            this->reserve(n);
+        }
+
+        // Get the value stored for `key`. The `std::nullopt_t` value is
+        // returned if the key is not found.
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (this->_slots.empty()) {
+                return {};
+            }
+            auto const i = this->probe(key);
+            this->record(key, i);
+            auto const& slot = this->_slots[i];
+            if (slot.occupied) {
+                return slot.value;
+            }
+            return {};
+        }
+
+        // Store a value for `key`, overwriting any existing value, and return
+        // the stored value.
+        auto insert(Key const& key, Store store) -> Store {
+            if (this->_slots.empty() || static_cast<float>(this->_size + 1) > this->_max_load_factor * std::size(this->_slots)) {
+                this->rehash(this->slots_for(this->_size + 1));
+            }
+            auto const i = this->probe(key);
+            this->record(key, i);
+            auto& slot = this->_slots[i];
+            if (!slot.occupied) {
+                slot.key = key;
+                slot.occupied = true;
+                ++this->_size;
+            }
+            return slot.value = store;
+        }
+
+        // Get the number of entries in the table.
+        auto size() const noexcept -> std::size_t {
+            return this->_size;
+        }
+
+        // Get the number of slots currently allocated.
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_slots);
+        }
+
+        // A `FlatCache` is unbounded, so it never evicts anything.
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        // Get the number of bytes allocated by the table.
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_slots) * sizeof(Slot);
+        }
+
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_probes;
+        }
+
+        // Remove every entry, keeping the allocated slots.
+        auto clear() noexcept -> void {
+            for (auto& slot: this->_slots) {
+                slot.occupied = false;
+            }
+            this->_size = 0;
+        }
+
+        // Call `f(key, value)` for every entry in the table.
+        template <typename Function>
+        auto for_each(Function f) const -> void {
+            for (auto const& slot: this->_slots) {
+                if (slot.occupied) {
+                    f(slot.key, slot.value);
+                }
+            }
+        }
+
+        // Remove every entry for which `pred(key, value)` is true. The survivors
+        // are rehashed into a table sized to fit them.
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto slots = std::vector<Slot>{};
+            std::swap(slots, this->_slots);
+            auto const size = this->_size;
+            this->_size = 0;
+            for (auto& slot: slots) {
+                if (slot.occupied) {
+                    slot.occupied = !pred(slot.key, slot.value);
+                    this->_size += slot.occupied;
+                }
+            }
+            this->_slots.resize(this->slots_for(this->_size));
+            for (auto const& slot: slots) {
+                if (slot.occupied) {
+                    this->_slots[this->probe(slot.key)] = slot;
+                }
+            }
+            return size - this->_size;
+        }
+
+        // Allocate enough slots to hold at least `n` entries without
+        // rehashing.
+        auto reserve(std::size_t n) -> void {
+            auto const capacity = this->slots_for(n);
+            if (capacity > std::size(this->_slots)) {
+                this->rehash(capacity);
+            }
+        }
+
+        auto load_factor() const noexcept -> float {
+            return this->_slots.empty() ? 0.0f : static_cast<float>(this->_size) / std::size(this->_slots);
+        }
+
+        auto max_load_factor() const noexcept -> float {
+            return this->_max_load_factor;
+        }
+
+        // Set the maximum load factor, which must lie in `(0, 1)`. The table
+        // is grown immediately if it is over the new limit.
+        auto max_load_factor(float factor) -> void {
+            if (!(factor > 0.0f && factor < 1.0f)) {
+                throw std::invalid_argument("max load factor must be in (0, 1)");
+            }
+            this->_max_load_factor = factor;
+            this->reserve(this->_size);
+        }
+};
+
+// The `MapCache<Key, Store>` policy is backed by a `std::map`. It was the
+// original cache implementation and is kept around as a baseline against
+// which to compare other policies.
+template <typename Key, typename Store>
+class MapCache {
+    private:
+        std::map<Key, Store> _map;
+        ProbeHistogram _probes;
+
+    public:
+        auto find(Key const& key) const -> std::optional<Store> {
+            auto const iter = this->_map.find(key);
+            if (iter != std::end(this->_map)) {
+                return iter->second;
+            }
+            return {};
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            return this->_map[key] = store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return std::size(this->_map);
+        }
+
+        // A `std::map` allocates a node per entry, so its capacity is its size.
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_map);
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        // Each entry lives in its own red-black tree node, which carries three
+        // pointers and a color alongside the entry itself.
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_map) * (sizeof(typename std::map<Key, Store>::value_type) + 4 * sizeof(void*));
+        }
+
+        // A tree doesn't probe, so the histogram is always empty.
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_probes;
+        }
+
+        auto clear() noexcept -> void {
+            this->_map.clear();
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const size = std::size(this->_map);
+            for (auto iter = std::begin(this->_map); iter != std::end(this->_map);) {
+                if (pred(iter->first, iter->second)) {
+                    iter = this->_map.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+            return size - std::size(this->_map);
+        }
+
+        auto reserve(std::size_t) noexcept -> void {}
+};
+
+// The `BoundedCache<Key, Store>` policy is an open-addressing table, much like
+// `FlatCache`, which will never hold more than a fixed number of entries. Once
+// it's full, each insertion first evicts an entry chosen by the CLOCK
+// algorithm: a "hand" sweeps around the table, decrementing each entry's
+// reference count and evicting the first entry whose count is already zero.
+// Looking up an entry resets its count. Every entry of a table starts with, and
+// is reset to, the same count, which is set when the table is constructed: the
+// higher the count, the more sweeps an unused entry survives.
+//
+// A `Context` keeps assembly and coassembly indices in separate tables, each
+// with its own bound, so the far more numerous pairs never evict an assembly
+// index. An assembly table can still be given a larger count than a coassembly
+// table, so that it holds on to the objects which were used recently over a
+// longer window.
+//
+// Evicted entries are simply recomputed the next time they are needed, so a
+// bounded cache yields exactly the same results as an unbounded one — it just
+// trades memory for time.
+template <typename Key, typename Store, typename Hash = key_hash<Key>>
+class BoundedCache {
+    private:
+        struct Slot {
+            Key key;
+            Store value;
+            bool occupied;
+            std::uint8_t references;
+        };
+
+        // The fraction of slots that may be occupied.
+        static constexpr float max_load_factor = 0.5f;
+
+        mutable std::vector<Slot> _slots;
+        std::size_t _size = 0;
+        std::size_t _max_entries;
+        std::size_t _evictions = 0;
+        std::size_t _hand = 0;
+        std::uint8_t _references;
+        mutable ProbeHistogram _probes;
+
+        auto home(Key const& key) const noexcept -> std::size_t {
+            return Hash{}(key) & (std::size(this->_slots) - 1);
+        }
+
+        auto probe(Key const& key) const noexcept -> std::size_t {
+            auto const mask = std::size(this->_slots) - 1;
+            auto i = this->home(key);
+            while (this->_slots[i].occupied && !(this->_slots[i].key == key)) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        // Record how far from its home slot `key` was found (or placed) at slot
+        // `i`, if statistics are being collected.
+        auto record(Key const& key, std::size_t i) const noexcept -> void {
+            if constexpr (collect_statistics) {
+                auto const mask = std::size(this->_slots) - 1;
+                this->_probes.record((i - (Hash{}(key) & mask)) & mask);
+            }
+        }
+
+        auto rehash(std::size_t capacity) -> void {
+            auto slots = std::vector<Slot>(capacity);
+            std::swap(slots, this->_slots);
+            for (auto const& slot: slots) {
+                if (slot.occupied) {
+                    this->_slots[this->probe(slot.key)] = slot;
+                }
+            }
+            this->_hand = 0;
+        }
+
+        // Remove the entry in slot `i`, shifting any displaced entries that
+        // follow it back toward their home slots so that probing still works.
+        auto erase(std::size_t i) noexcept -> void {
+            auto const mask = std::size(this->_slots) - 1;
+            for (auto j = (i + 1) & mask; this->_slots[j].occupied; j = (j + 1) & mask) {
+                auto const k = this->home(this->_slots[j].key);
+                // The entry at `j` may be moved into the hole at `i` only if its home
+                // slot does not lie cyclically within `(i, j]`.
+                auto const stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+                if (!stays) {
+                    this->_slots[i] = this->_slots[j];
+                    i = j;
+                }
+            }
+            this->_slots[i].occupied = false;
+            --this->_size;
+        }
+
+        // Advance the CLOCK hand until an entry is evicted.
+        auto evict() noexcept -> void {
+            auto const mask = std::size(this->_slots) - 1;
+            while (true) {
+                auto& slot = this->_slots[this->_hand];
+                if (slot.occupied) {
+                    if (slot.references == 0) {
+                        this->erase(this->_hand);
+                        ++this->_evictions;
+                        return;
+                    }
+                    --slot.references;
+                }
+                this->_hand = (this->_hand + 1) & mask;
+            }
+        }
+
+        static auto slots_for(std::size_t n) noexcept -> std::size_t {
+            auto capacity = std::size_t{8};
+            while (static_cast<float>(n) > max_load_factor * capacity) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+    public:
+        // The number of entries held by a default-constructed cache.
+        static constexpr std::size_t default_max_entries = std::size_t{1} << 22;
+
+        BoundedCache(): BoundedCache(default_max_entries) {}
+
+        // Construct a cache which holds at most `max_entries` entries, each of
+        // which survives `references` sweeps of the CLOCK hand without being
+        // looked up.
+        explicit BoundedCache(std::size_t max_entries, std::uint8_t references = 1):
+            _max_entries{max_entries}, _references{references} {
+            if (max_entries == 0) {
+                throw std::invalid_argument("bounded cache must hold at least one entry");
+            }
+        }
+
+        // Construct a cache whose table will never occupy more than `bytes` bytes.
+        static auto with_memory(std::size_t bytes, std::uint8_t references = 1) -> BoundedCache {
+            auto slots = std::size_t{8};
+            while (2 * slots * sizeof(Slot) <= bytes) {
+                slots <<= 1;
+            }
+            return BoundedCache(static_cast<std::size_t>(max_load_factor * slots), references);
+        }
+
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (this->_slots.empty()) {
+                return {};
+            }
+            auto const i = this->probe(key);
+            this->record(key, i);
+            auto& slot = this->_slots[i];
+            if (slot.occupied) {
+                slot.references = this->_references;
+                return slot.value;
+            }
+            return {};
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            auto const n = std::min(this->_size + 1, this->_max_entries);
+            if (this->_slots.empty() || static_cast<float>(n) > max_load_factor * std::size(this->_slots)) {
+                this->rehash(slots_for(n));
+            }
+            auto i = this->probe(key);
+            if (!this->_slots[i].occupied) {
+                if (this->_size == this->_max_entries) {
+                    this->evict();
+                    i = this->probe(key);
+                }
+                this->record(key, i);
+                this->_slots[i].key = key;
+                this->_slots[i].occupied = true;
+                ++this->_size;
+            }
+            this->_slots[i].references = this->_references;
+            return this->_slots[i].value = store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_size;
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_slots);
+        }
+
+        // Get the maximum number of entries the cache will hold.
+        auto max_entries() const noexcept -> std::size_t {
+            return this->_max_entries;
+        }
+
+        // Get the reference count each entry starts with and is reset to.
+        auto references() const noexcept -> std::uint8_t {
+            return this->_references;
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return this->_evictions;
+        }
+
+        // Get the number of bytes allocated by the table.
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_slots) * sizeof(Slot);
+        }
+
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_probes;
+        }
+
+        auto clear() noexcept -> void {
+            for (auto& slot: this->_slots) {
+                slot.occupied = false;
+            }
+            this->_size = 0;
+            this->_hand = 0;
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto slots = std::vector<Slot>{};
+            std::swap(slots, this->_slots);
+            auto const size = this->_size;
+            this->_size = 0;
+            for (auto& slot: slots) {
+                if (slot.occupied) {
+                    slot.occupied = !pred(slot.key, slot.value);
+                    this->_size += slot.occupied;
+                }
+            }
+            this->_slots.resize(slots_for(this->_size));
+            for (auto const& slot: slots) {
+                if (slot.occupied) {
+                    this->_slots[this->probe(slot.key)] = slot;
+                }
+            }
+            this->_hand = 0;
+            return size - this->_size;
+        }
+
+        auto reserve(std::size_t n) -> void {
+            auto const capacity = slots_for(std::min(n, this->_max_entries));
+            if (capacity > std::size(this->_slots)) {
+                this->rehash(capacity);
+            }
+        }
+};
+
+// The `CompactCache<Key, Store>` policy is an open-addressing table laid out
+// to minimize the memory per entry. The (co)assembly indices we store rarely
+// exceed a few hundred, so rather than storing a full `Store` alongside each
+// key, it stores a `Narrow` value (8 bits by default) in a separate array. The
+// largest narrow value marks an empty slot, and the next largest marks a value
+// too wide to fit, which is then looked up in an overflow `FlatCache`. With
+// 8-bit values a pair of hashes occupies 17 bytes rather than the 24 bytes of
+// a `FlatCache` slot, and a single hash 9 bytes rather than 16.
+template <typename Key, typename Store, typename Narrow = std::uint8_t, typename Hash = key_hash<Key>>
+class CompactCache {
+    private:
+        static constexpr Narrow empty = std::numeric_limits<Narrow>::max();
+        static constexpr Narrow overflow = empty - 1;
+
+        std::vector<Key> _keys;
+        std::vector<Narrow> _values;
+        FlatCache<Key, Store, Hash> _overflow;
+        std::size_t _size = 0;
+        float _max_load_factor = 0.5f;
+        mutable ProbeHistogram _probes;
+
+        auto probe(Key const& key) const noexcept -> std::size_t {
+            auto const mask = std::size(this->_values) - 1;
+            auto i = Hash{}(key) & mask;
+            while (this->_values[i] != empty && !(this->_keys[i] == key)) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        // Record how far from its home slot `key` was found (or placed) at slot
+        // `i`, if statistics are being collected.
+        auto record(Key const& key, std::size_t i) const noexcept -> void {
+            if constexpr (collect_statistics) {
+                auto const mask = std::size(this->_values) - 1;
+                this->_probes.record((i - (Hash{}(key) & mask)) & mask);
+            }
+        }
+
+        auto rehash(std::size_t capacity) -> void {
+            auto keys = std::vector<Key>(capacity);
+            auto values = std::vector<Narrow>(capacity, empty);
+            std::swap(keys, this->_keys);
+            std::swap(values, this->_values);
+            for (std::size_t i = 0; i < std::size(values); ++i) {
+                if (values[i] != empty) {
+                    auto const j = this->probe(keys[i]);
+                    this->_keys[j] = keys[i];
+                    this->_values[j] = values[i];
+                }
+            }
+        }
+
+        auto slots_for(std::size_t n) const noexcept -> std::size_t {
+            auto capacity = std::size_t{8};
+            while (static_cast<float>(n) > this->_max_load_factor * capacity) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+    public:
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (this->_values.empty()) {
+                return {};
+            }
+            auto const i = this->probe(key);
+            this->record(key, i);
+            auto const value = this->_values[i];
+            if (value == empty) {
+                return {};
+            } else if (value == overflow) {
+                return this->_overflow.find(key);
+            }
+            return static_cast<Store>(value);
+        }
+
+        // Store a value for `key`. If an entry which previously overflowed is
+        // overwritten with a narrow value, its stale overflow entry is left in
+        // place; it is unreachable and just costs a little memory.
+        auto insert(Key const& key, Store store) -> Store {
+            if (this->_values.empty() || static_cast<float>(this->_size + 1) > this->_max_load_factor * std::size(this->_values)) {
+                this->rehash(this->slots_for(this->_size + 1));
+            }
+            auto const i = this->probe(key);
+            this->record(key, i);
+            if (this->_values[i] == empty) {
+                this->_keys[i] = key;
+                ++this->_size;
+            }
+            if (store < static_cast<Store>(overflow)) {
+                this->_values[i] = static_cast<Narrow>(store);
+            } else {
+                this->_values[i] = overflow;
+                this->_overflow.insert(key, store);
+            }
+            return store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_size;
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_values);
+        }
+
+        // Get the number of entries whose values were too wide to store inline.
+        auto overflowed() const noexcept -> std::size_t {
+            return this->_overflow.size();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_values) * (sizeof(Key) + sizeof(Narrow)) + this->_overflow.bytes();
+        }
+
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_probes;
+        }
+
+        auto clear() noexcept -> void {
+            std::fill(std::begin(this->_values), std::end(this->_values), empty);
+            this->_overflow.clear();
+            this->_size = 0;
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto keys = std::vector<Key>{};
+            auto values = std::vector<Narrow>{};
+            auto wide = FlatCache<Key, Store, Hash>{};
+            std::swap(keys, this->_keys);
+            std::swap(values, this->_values);
+            std::swap(wide, this->_overflow);
+
+            auto const value = [&](std::size_t i) -> Store {
+                return (values[i] == overflow) ? wide.find(keys[i]).value() : static_cast<Store>(values[i]);
+            };
+
+            auto const size = this->_size;
+            this->_size = 0;
+            for (std::size_t i = 0; i < std::size(values); ++i) {
+                if (values[i] != empty && pred(keys[i], value(i))) {
+                    values[i] = empty;
+                } else if (values[i] != empty) {
+                    ++this->_size;
+                }
+            }
+            this->_keys.resize(this->slots_for(this->_size));
+            this->_values.resize(this->slots_for(this->_size), empty);
+            for (std::size_t i = 0; i < std::size(values); ++i) {
+                if (values[i] != empty) {
+                    auto const j = this->probe(keys[i]);
+                    this->_keys[j] = keys[i];
+                    this->_values[j] = values[i];
+                    if (values[i] == overflow) {
+                        this->_overflow.insert(keys[i], value(i));
+                    }
+                }
+            }
+            return size - this->_size;
+        }
+
+        auto reserve(std::size_t n) -> void {
+            auto const capacity = this->slots_for(n);
+            if (capacity > std::size(this->_values)) {
+                this->rehash(capacity);
+            }
+        }
+
+        auto load_factor() const noexcept -> float {
+            return this->_values.empty() ? 0.0f : static_cast<float>(this->_size) / std::size(this->_values);
+        }
+
+        auto max_load_factor() const noexcept -> float {
+            return this->_max_load_factor;
+        }
+
+        auto max_load_factor(float factor) -> void {
+            if (!(factor > 0.0f && factor < 1.0f)) {
+                throw std::invalid_argument("max load factor must be in (0, 1)");
+            }
+            this->_max_load_factor = factor;
+            this->reserve(this->_size);
+        }
+};
+
+// The `BloomFilter<Key>` is an approximate membership filter over cache keys.
+// It never reports that an inserted key is absent, but may report that an
+// absent key is present. It is "register blocked": each key sets a handful of
+// bits within a single 64-bit word, so a query costs at most one cache miss.
+template <typename Key, typename Hash = key_hash<Key>>
+class BloomFilter {
+    private:
+        // The number of bits set per key.
+        static constexpr int bits_per_key = 4;
+
+        std::vector<std::uint64_t> _words;
+        int _shift = 64;
+
+        // The word index is drawn from the high bits of the key's hash, which are
+        // not used to choose the key's slot in an open-addressing table; the bits
+        // within the word are drawn from a second round of mixing.
+        auto locate(Key const& key) const noexcept -> std::pair<std::size_t, std::uint64_t> {
+            auto const hash = Hash{}(key);
+            auto const index = (this->_shift == 64) ? 0 : hash >> this->_shift;
+            auto bits = mix(hash);
+            auto mask = std::uint64_t{0};
+            for (int i = 0; i < bits_per_key; ++i, bits >>= 6) {
+                mask |= std::uint64_t{1} << (bits & 63);
+            }
+            return { index, mask };
+        }
+
+    public:
+        BloomFilter() = default;
+
+        // Construct a filter with at least `words` 64-bit words. The number of
+        // words is rounded up to a power of two.
+        explicit BloomFilter(std::size_t words) {
+            auto n = std::size_t{1};
+            this->_shift = 64;
+            while (n < words) {
+                n <<= 1;
+                --this->_shift;
+            }
+            this->_words.resize(n, 0);
+        }
+
+        auto insert(Key const& key) noexcept -> void {
+            auto const [index, mask] = this->locate(key);
+            this->_words[index] |= mask;
+        }
+
+        // Is the key possibly in the filter?
+        auto contains(Key const& key) const noexcept -> bool {
+            if (this->_words.empty()) {
+                return false;
+            }
+            auto const [index, mask] = this->locate(key);
+            return (this->_words[index] & mask) == mask;
+        }
+
+        auto words() const noexcept -> std::size_t {
+            return std::size(this->_words);
+        }
+
+        auto clear() noexcept -> void {
+            std::fill(std::begin(this->_words), std::end(this->_words), 0);
+        }
+};
+
+// The `FilteredCache<Key, Store>` policy puts a `BloomFilter` in front of a
+// `FlatCache`. While a cache is cold almost every lookup misses, and a miss
+// which the (much smaller) filter rejects returns without touching the table
+// at all. The filter has one 64-bit word for every eight slots of the table
+// and is rebuilt whenever the table grows or entries are erased.
+template <typename Key, typename Store, typename Hash = key_hash<Key>>
+class FilteredCache {
+    private:
+        static constexpr std::size_t slots_per_word = 8;
+
+        FlatCache<Key, Store, Hash> _table;
+        BloomFilter<Key, Hash> _filter;
+        mutable std::size_t _rejections = 0;
+
+        // Resize the filter to match the table and refill it from the table.
+        auto refilter() -> void {
+            this->_filter = BloomFilter<Key, Hash>(this->_table.capacity() / slots_per_word);
+            this->_table.for_each([this](Key const& key, Store const&) {
+                this->_filter.insert(key);
+            });
+        }
+
+    public:
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (!this->_filter.contains(key)) {
+                ++this->_rejections;
+                return {};
+            }
+            return this->_table.find(key);
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            auto const capacity = this->_table.capacity();
+            this->_table.insert(key, store);
+            if (this->_table.capacity() != capacity) {
+                this->refilter();
+            } else {
+                this->_filter.insert(key);
+            }
+            return store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_table.size();
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return this->_table.capacity();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        // Get the number of lookups answered by the filter alone.
+        auto rejections() const noexcept -> std::size_t {
+            return this->_rejections;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return this->_table.bytes() + this->_filter.words() * sizeof(std::uint64_t);
+        }
+
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_table.probe_lengths();
+        }
+
+        auto clear() noexcept -> void {
+            this->_table.clear();
+            this->_filter.clear();
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const erased = this->_table.erase_if(pred);
+            this->refilter();
+            return erased;
+        }
+
+        auto reserve(std::size_t n) -> void {
+            auto const capacity = this->_table.capacity();
+            this->_table.reserve(n);
+            if (this->_table.capacity() != capacity) {
+                this->refilter();
+            }
+        }
+};
+
+// The `DenseCache<Key, Store>` policy is for objects whose hashes are small,
+// dense integer IDs (e.g. `InternedString`s; see `intern.h`) rather than
+// well-mixed hashes. Values are stored in a flat array indexed directly by
+// ID, so a lookup is a single load with no hashing or probing. The largest
+// `Store` value marks empty slots, and so cannot itself be stored.
+//
+// The array is as long as the largest ID stored, so don't use a `DenseCache`
+// with ordinary hashes.
+template <typename Key, typename Store>
+class DenseCache {
+    private:
+        static constexpr Store empty = std::numeric_limits<Store>::max();
+
+        std::vector<Store> _values;
+        std::size_t _size = 0;
+        ProbeHistogram _probes;
+
+    public:
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            if (key < std::size(this->_values) && this->_values[key] != empty) {
+                return this->_values[key];
+            }
+            return {};
+        }
+
+        auto insert(Key const& key, Store store) -> Store {
+            if (key >= std::size(this->_values)) {
+                this->_values.resize(std::max(static_cast<std::size_t>(key) + 1, 2 * std::size(this->_values)), empty);
+            }
+            this->_size += (this->_values[key] == empty);
+            return this->_values[key] = store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_size;
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_values);
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_values) * sizeof(Store);
+        }
+
+        // Nothing is ever probed, so the histogram is always empty.
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_probes;
+        }
+
+        auto clear() noexcept -> void {
+            std::fill(std::begin(this->_values), std::end(this->_values), empty);
+            this->_size = 0;
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const size = this->_size;
+            for (std::size_t key = 0; key < std::size(this->_values); ++key) {
+                auto& value = this->_values[key];
+                if (value != empty && pred(static_cast<Key>(key), value)) {
+                    value = empty;
+                    --this->_size;
+                }
+            }
+            return size - this->_size;
+        }
+
+        // Allocate room for the IDs `0` through `n - 1`.
+        auto reserve(std::size_t n) -> void {
+            if (n > std::size(this->_values)) {
+                this->_values.resize(n, empty);
+            }
+        }
+};
+
+// A flat array indexed by pairs of IDs would need quadratically many slots,
+// nearly all of them empty, so pairs are instead packed into a single 64-bit
+// key in a `FlatCache`. This halves the size of the keys and hashes one word
+// rather than two. Only IDs which fit into 32 bits can be packed, so the
+// (rare) pairs with a wider ID are kept in a second table keyed on the pair
+// itself, rather than let them share a packed key with another pair.
+template <typename Id, typename Store>
+class DenseCache<std::pair<Id, Id>, Store> {
+    private:
+        FlatCache<std::uint64_t, Store> _table;
+        FlatCache<std::pair<Id, Id>, Store> _wide;
+
+        static auto pack(std::pair<Id, Id> const& key) noexcept -> std::uint64_t {
+            return (static_cast<std::uint64_t>(key.first) << 32) | static_cast<std::uint32_t>(key.second);
+        }
+
+        static auto unpack(std::uint64_t key) noexcept -> std::pair<Id, Id> {
+            return { static_cast<Id>(key >> 32), static_cast<Id>(key & 0xffffffffull) };
+        }
+
+        // Determine whether both IDs of a pair fit into 32 bits.
+        static auto packable(std::pair<Id, Id> const& key) noexcept -> bool {
+            constexpr auto max = std::numeric_limits<std::uint32_t>::max();
+            return static_cast<std::uint64_t>(key.first) <= max && static_cast<std::uint64_t>(key.second) <= max;
+        }
+
+    public:
+        auto find(std::pair<Id, Id> const& key) const noexcept -> std::optional<Store> {
+            if (!packable(key)) {
+                return this->_wide.find(key);
+            }
+            return this->_table.find(pack(key));
+        }
+
+        auto insert(std::pair<Id, Id> const& key, Store store) -> Store {
+            if (!packable(key)) {
+                return this->_wide.insert(key, store);
+            }
+            return this->_table.insert(pack(key), store);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_table.size() + this->_wide.size();
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return this->_table.capacity() + this->_wide.capacity();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return this->_table.bytes() + this->_wide.bytes();
+        }
+
+        // Get the probe lengths of the packed table, which holds every pair
+        // unless the IDs outgrow 32 bits.
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_table.probe_lengths();
+        }
+
+        auto clear() noexcept -> void {
+            this->_table.clear();
+            this->_wide.clear();
+        }
+
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto const erased = this->_table.erase_if([&pred](std::uint64_t key, Store value) { return pred(unpack(key), value); });
+            return erased + this->_wide.erase_if(pred);
+        }
+
+        auto reserve(std::size_t n) -> void {
+            this->_table.reserve(n);
+        }
+};
+
+}
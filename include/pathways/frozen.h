@@ -0,0 +1,311 @@
+#pragma once
+
+#include "cache.h"
+#include "pathways.h"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace pathways {
+
+// The `FrozenCache<Key, Store>` policy is an immutable snapshot of a warmed
+// cache, meant for replays which only ever read. Its keys are laid out by a
+// minimal perfect hash function, built BBHash-style: each key is hashed into a
+// bit array four times as long as the number of keys still to be placed; keys
+// which land on a bit of their own are placed, and those which collide move on
+// to the next, smaller, level. Every placed key's position in the key and
+// value arrays is the rank of its bit among all the levels, which is read off
+// a count stored alongside each word of bits. The function takes about ten
+// bits per key, and a lookup walks 1.3 levels on average, loads a single key
+// and a single (narrow) value, and never probes.
+//
+// As in `CompactCache`, the values are stored as `Narrow` integers with the
+// largest value marking an entry too wide to fit. Those entries, the few keys
+// which the levels fail to separate and anything inserted after freezing go to
+// a `FlatCache` spill table, which is usually empty.
+//
+// Looking keys up never modifies a frozen cache (unless statistics are being
+// collected), so any number of threads may read one at once without locking;
+// inserting into it is not thread-safe.
+template <typename Key, typename Store, typename Narrow = std::uint8_t, typename Hash = key_hash<Key>>
+class FrozenCache {
+    private:
+        static constexpr Narrow overflow = std::numeric_limits<Narrow>::max();
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t max_levels = 24;
+        static constexpr std::size_t gamma = 4;
+        static constexpr std::uint64_t seed = 0x9e3779b97f4a7c15ull;
+
+        // A `Word` holds 64 bits of the levels, along with the number of bits
+        // set in every word before it, so that ranking a bit costs a single
+        // load and a single `popcount`.
+        struct Word {
+            std::uint64_t bits;
+            std::uint64_t rank;
+        };
+
+        // Each level's bits are the `size` bits starting at bit `offset`,
+        // both of which are multiples of 64.
+        struct Level {
+            std::size_t offset;
+            std::size_t size;
+        };
+
+        std::vector<Level> _levels;
+        std::vector<Word> _words;
+        std::vector<Key> _keys;
+        std::vector<Narrow> _values;
+        FlatCache<Key, Store, Hash> _spill;
+        std::size_t _size = 0;
+
+        // Get the position of the key with slot hash `h` among the `size`
+        // bits of a level, reducing the rehashed key by multiplication rather
+        // than by a modulus.
+        static auto position(std::uint64_t h, std::size_t level, std::size_t size) noexcept -> std::size_t {
+            __extension__ using uint128 = unsigned __int128;
+            return static_cast<std::size_t>((static_cast<uint128>(mix(h + level * seed)) * size) >> 64);
+        }
+
+        // Get the rank of bit `p` of the levels, i.e. the number of bits set
+        // before it.
+        auto rank(std::size_t p) const noexcept -> std::size_t {
+            auto const& word = this->_words[p / 64];
+            auto const below = word.bits & ((std::uint64_t{1} << (p % 64)) - 1);
+            return static_cast<std::size_t>(word.rank) + static_cast<std::size_t>(__builtin_popcountll(below));
+        }
+
+        // Get the index of `key` in the key and value arrays, or `none` if it
+        // isn't one of the frozen keys.
+        auto slot(Key const& key) const noexcept -> std::size_t {
+            auto const h = static_cast<std::uint64_t>(Hash{}(key));
+            for (std::size_t l = 0; l < std::size(this->_levels); ++l) {
+                auto const [offset, size] = this->_levels[l];
+                auto const p = offset + position(h, l, size);
+                if (this->_words[p / 64].bits & (std::uint64_t{1} << (p % 64))) {
+                    auto const i = this->rank(p);
+                    return (this->_keys[i] == key) ? i : none;
+                }
+            }
+            return none;
+        }
+
+        // Build the levels for `entries`, returning the global bit position of
+        // each placed entry. The entries which couldn't be placed are spilled.
+        auto build(std::vector<std::pair<Key, Store>> const& entries) -> std::vector<std::pair<std::size_t, std::size_t>> {
+            auto placed = std::vector<std::pair<std::size_t, std::size_t>>{};
+            placed.reserve(std::size(entries));
+
+            auto remaining = std::vector<std::size_t>(std::size(entries));
+            auto hashes = std::vector<std::uint64_t>(std::size(entries));
+            for (std::size_t e = 0; e < std::size(entries); ++e) {
+                remaining[e] = e;
+                hashes[e] = static_cast<std::uint64_t>(Hash{}(entries[e].first));
+            }
+
+            for (std::size_t l = 0; l < max_levels && !remaining.empty(); ++l) {
+                auto const words = (gamma * std::size(remaining) + 63) / 64;
+                auto const size = 64 * words;
+                auto once = std::vector<std::uint64_t>(words);
+                auto twice = std::vector<std::uint64_t>(words);
+                for (auto const e: remaining) {
+                    auto const p = position(hashes[e], l, size);
+                    auto const bit = std::uint64_t{1} << (p % 64);
+                    twice[p / 64] |= once[p / 64] & bit;
+                    once[p / 64] |= bit;
+                }
+
+                auto const offset = 64 * std::size(this->_words);
+                for (std::size_t w = 0; w < words; ++w) {
+                    this->_words.push_back(Word{once[w] & ~twice[w], 0});
+                }
+                this->_levels.push_back(Level{offset, size});
+
+                auto collided = std::vector<std::size_t>{};
+                for (auto const e: remaining) {
+                    auto const p = position(hashes[e], l, size);
+                    if (twice[p / 64] & (std::uint64_t{1} << (p % 64))) {
+                        collided.push_back(e);
+                    } else {
+                        placed.emplace_back(offset + p, e);
+                    }
+                }
+                remaining = std::move(collided);
+            }
+
+            for (auto const e: remaining) {
+                this->_spill.insert(entries[e].first, entries[e].second);
+            }
+            return placed;
+        }
+
+    public:
+        FrozenCache() = default;
+
+        // Freeze a set of distinct entries.
+        explicit FrozenCache(std::vector<std::pair<Key, Store>> const& entries) {
+            auto const placed = this->build(entries);
+
+            auto count = std::uint64_t{0};
+            for (auto& word: this->_words) {
+                word.rank = count;
+                count += static_cast<std::uint64_t>(__builtin_popcountll(word.bits));
+            }
+
+            this->_keys.resize(std::size(placed));
+            this->_values.resize(std::size(placed));
+            for (auto const& [p, e]: placed) {
+                auto const i = this->rank(p);
+                auto const& [key, store] = entries[e];
+                this->_keys[i] = key;
+                if (store < static_cast<Store>(overflow)) {
+                    this->_values[i] = static_cast<Narrow>(store);
+                } else {
+                    this->_values[i] = overflow;
+                    this->_spill.insert(key, store);
+                }
+            }
+            this->_size = std::size(entries);
+        }
+
+        // Freeze the entries of another cache, which must provide a
+        // `for_each` (as `FlatCache` does).
+        template <typename Source>
+        explicit FrozenCache(Source const& source): FrozenCache(entries_of(source)) {}
+
+        // Get every entry of a cache which provides a `for_each`.
+        template <typename Source>
+        static auto entries_of(Source const& source) -> std::vector<std::pair<Key, Store>> {
+            auto entries = std::vector<std::pair<Key, Store>>{};
+            entries.reserve(source.size());
+            source.for_each([&entries](Key const& key, Store const& store) {
+                entries.emplace_back(key, store);
+            });
+            return entries;
+        }
+
+        auto find(Key const& key) const noexcept -> std::optional<Store> {
+            auto const i = this->slot(key);
+            if (i != none && this->_values[i] != overflow) {
+                return static_cast<Store>(this->_values[i]);
+            }
+            return this->_spill.find(key);
+        }
+
+        // Store a value for `key`. Frozen keys are updated in place; any other
+        // key goes to the spill table.
+        auto insert(Key const& key, Store store) -> Store {
+            auto const i = this->slot(key);
+            if (i == none) {
+                auto const size = this->_spill.size();
+                this->_spill.insert(key, store);
+                this->_size += this->_spill.size() - size;
+            } else if (store < static_cast<Store>(overflow)) {
+                this->_values[i] = static_cast<Narrow>(store);
+            } else {
+                this->_values[i] = overflow;
+                this->_spill.insert(key, store);
+            }
+            return store;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_size;
+        }
+
+        auto capacity() const noexcept -> std::size_t {
+            return std::size(this->_keys) + this->_spill.capacity();
+        }
+
+        auto evictions() const noexcept -> std::size_t {
+            return 0;
+        }
+
+        // Get the number of levels of the perfect hash function.
+        auto levels() const noexcept -> std::size_t {
+            return std::size(this->_levels);
+        }
+
+        // Get the number of entries held by the spill table.
+        auto spilled() const noexcept -> std::size_t {
+            return this->_spill.size();
+        }
+
+        auto bytes() const noexcept -> std::size_t {
+            return std::size(this->_words) * sizeof(Word)
+                 + std::size(this->_keys) * sizeof(Key)
+                 + std::size(this->_values) * sizeof(Narrow)
+                 + this->_spill.bytes();
+        }
+
+        // Only the spill table is ever probed.
+        auto probe_lengths() const noexcept -> ProbeHistogram const& {
+            return this->_spill.probe_lengths();
+        }
+
+        auto clear() noexcept -> void {
+            this->_levels.clear();
+            this->_words.clear();
+            this->_keys.clear();
+            this->_values.clear();
+            this->_spill.clear();
+            this->_size = 0;
+        }
+
+        // Call `f(key, value)` for every entry in the cache.
+        template <typename Function>
+        auto for_each(Function f) const -> void {
+            for (std::size_t i = 0; i < std::size(this->_keys); ++i) {
+                if (this->_values[i] != overflow) {
+                    f(this->_keys[i], static_cast<Store>(this->_values[i]));
+                }
+            }
+            this->_spill.for_each([this, &f](Key const& key, Store const& store) {
+                auto const i = this->slot(key);
+                if (i == none || this->_values[i] == overflow) {
+                    f(key, store);
+                }
+            });
+        }
+
+        // Remove every entry for which `pred(key, value)` is true, refreezing
+        // the survivors.
+        template <typename Predicate>
+        auto erase_if(Predicate pred) -> std::size_t {
+            auto entries = std::vector<std::pair<Key, Store>>{};
+            this->for_each([&entries, &pred](Key const& key, Store const& store) {
+                if (!pred(key, store)) {
+                    entries.emplace_back(key, store);
+                }
+            });
+            auto const size = this->_size;
+            *this = FrozenCache(entries);
+            return size - this->_size;
+        }
+
+        // A frozen cache isn't meant to grow, so reserving does nothing.
+        auto reserve(std::size_t) noexcept -> void {}
+};
+
+// Freeze the caches of a warmed context, e.g.
+//
+// ```cpp
+// Context<std::string> ctx;
+// for (auto const& str: strs) {
+//     ctx.assembly_index(str);
+// }
+// auto frozen = freeze(ctx);
+// ```
+//
+// The frozen context computes the same indices as the original, but reads its
+// caches through perfect hashes. Its caches must be built from caches which
+// provide a `for_each`, and the original's retention policy isn't carried over.
+template <typename T, typename Disassembly, template <typename, typename> class CachePolicy, typename Hash>
+auto freeze(Context<T, Disassembly, CachePolicy, Hash> const& ctx) -> Context<T, Disassembly, FrozenCache, Hash> {
+    using Frozen = Context<T, Disassembly, FrozenCache, Hash>;
+    return Frozen{ typename Frozen::assembly_cache_type(ctx.assembly_cache()),
+                   typename Frozen::coassembly_cache_type(ctx.coassembly_cache()),
+                   ctx.hasher() };
+}
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "cache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pathways {
+
+// A `PrefixHash` precomputes polynomial hashes of every prefix of a string so
+// that the hash of any substring can be had in constant time. The hash of a
+// string `s` of length `n` is
+//
+//     h(s) = (s[0] + 1) * B^(n-1) + (s[1] + 1) * B^(n-2) + ... + (s[n-1] + 1)
+//
+// taken modulo the Mersenne prime `2^61 - 1`, for some base `B` (by default
+// `default_base`). The hash of `s[i, i + n)` is then
+// `h(s[0, i + n)) - h(s[0, i)) * B^n`, and since the hash depends only on the
+// characters of the substring, equal substrings anywhere in the string (or in
+// any other string) have equal hashes.
+//
+// Characters are offset by one so that strings which differ only by leading
+// `'\0'`s hash differently.
+class PrefixHash {
+    public:
+        static constexpr std::uint64_t modulus = (std::uint64_t{1} << 61) - 1;
+        static constexpr std::uint64_t default_base = 0x1fb5c3a6d2e8b9d3ull % modulus;
+        static constexpr std::uint64_t alternate_base = 0x0c6a4a7935bd1e99ull % modulus;
+
+    private:
+        std::vector<std::uint64_t> _prefix;
+        std::vector<std::uint64_t> _power;
+
+        static constexpr auto reduce(std::uint64_t x) noexcept -> std::uint64_t {
+            x = (x & modulus) + (x >> 61);
+            return (x >= modulus) ? x - modulus : x;
+        }
+
+        // Multiply two residues modulo `2^61 - 1` without losing the high bits.
+        static constexpr auto multiply(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+            __extension__ using uint128 = unsigned __int128;
+            auto const product = static_cast<uint128>(a) * b;
+            auto const low = static_cast<std::uint64_t>(product) & modulus;
+            auto const high = static_cast<std::uint64_t>(product >> 61);
+            return reduce(low + high);
+        }
+
+    public:
+        PrefixHash() = default;
+
+        explicit PrefixHash(std::string_view str, std::uint64_t base = default_base): _prefix(std::size(str) + 1), _power(std::size(str) + 1) {
+            this->_power[0] = 1;
+            for (std::size_t i = 0; i < std::size(str); ++i) {
+                auto const c = static_cast<std::uint64_t>(static_cast<unsigned char>(str[i])) + 1;
+                this->_prefix[i + 1] = reduce(multiply(this->_prefix[i], base) + c);
+                this->_power[i + 1] = multiply(this->_power[i], base);
+            }
+        }
+
+        // Get the length of the hashed string.
+        auto size() const noexcept -> std::size_t {
+            return std::empty(this->_prefix) ? 0 : std::size(this->_prefix) - 1;
+        }
+
+        // Get the hash of the `length` characters starting at `offset`.
+        auto operator()(std::size_t offset, std::size_t length) const noexcept -> std::uint64_t {
+            auto const whole = this->_prefix[offset + length];
+            auto const head = multiply(this->_prefix[offset], this->_power[length]);
+            return reduce(whole + modulus - head);
+        }
+
+        // Hash a string directly, without precomputing any prefixes. This
+        // agrees with hashing the whole of a `PrefixHash` built from `str`
+        // with the same `base`.
+        static auto hash(std::string_view str, std::uint64_t base = default_base) noexcept -> std::uint64_t {
+            auto h = std::uint64_t{0};
+            for (auto const c: str) {
+                h = append(h, c, base);
+            }
+            return h;
+        }
+
+        // Get the hash of a string with hash `h` once `c` is appended to it.
+        static auto append(std::uint64_t h, char c, std::uint64_t base = default_base) noexcept -> std::uint64_t {
+            return reduce(multiply(h, base) + static_cast<unsigned char>(c) + 1);
+        }
+
+        // Get the hash of a string of `n` characters with hash `h` once its
+        // first character, `c`, is removed. The `power` must be `base^(n - 1)`.
+        static auto remove_front(std::uint64_t h, char c, std::uint64_t power) noexcept -> std::uint64_t {
+            auto const front = multiply(static_cast<std::uint64_t>(static_cast<unsigned char>(c)) + 1, power);
+            return reduce(h + modulus - front);
+        }
+
+        // Get `base^exponent` modulo `2^61 - 1`.
+        static constexpr auto pow(std::uint64_t base, std::uint64_t exponent) noexcept -> std::uint64_t {
+            auto result = std::uint64_t{1};
+            for (; exponent != 0; exponent >>= 1) {
+                if (exponent & 1) {
+                    result = multiply(result, base);
+                }
+                base = multiply(base, base);
+            }
+            return result;
+        }
+
+        // Get the inverse of `base` modulo the (prime) modulus, so that
+        // multiplying by it divides by `base`.
+        static constexpr auto inverse(std::uint64_t base) noexcept -> std::uint64_t {
+            return pow(base, modulus - 2);
+        }
+
+        // Multiply two hashes, or a hash and a power, modulo `2^61 - 1`.
+        static constexpr auto times(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+            return multiply(a, b);
+        }
+};
+
+// The `PolynomialHash` hasher hashes strings with `PrefixHash::hash`, so a
+// string's hash agrees with that of any `Substring` with the same characters.
+struct PolynomialHash {
+    auto operator()(std::string_view str) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(PrefixHash::hash(str));
+    }
+};
+
+// A `Fingerprint` is a 128-bit hash of an object. A `Context` keys its caches
+// on object hashes rather than on the objects themselves, so two objects with
+// the same hash are indistinguishable and a collision silently yields the
+// wrong (co)assembly index. With 64-bit hashes, a cache of a few billion
+// entries is all but certain to see a collision; with 128-bit fingerprints the
+// odds are negligible no matter how large the cache grows.
+struct Fingerprint {
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+
+    friend auto operator==(Fingerprint const& x, Fingerprint const& y) noexcept -> bool {
+        return x.high == y.high && x.low == y.low;
+    }
+
+    friend auto operator!=(Fingerprint const& x, Fingerprint const& y) noexcept -> bool {
+        return !(x == y);
+    }
+
+    friend auto operator<(Fingerprint const& x, Fingerprint const& y) noexcept -> bool {
+        return x.high < y.high || (x.high == y.high && x.low < y.low);
+    }
+};
+
+// Fingerprint a string eight bytes at a time, running two independent 64-bit
+// lanes over the words of the string. The final (partial) word is padded with
+// zeros and the length is folded into both lanes, so strings which differ only
+// by trailing `'\0'`s fingerprint differently.
+inline auto fingerprint(std::string_view str) noexcept -> Fingerprint {
+    auto high = std::uint64_t{0x9e3779b97f4a7c15ull};
+    auto low = std::uint64_t{0xc2b2ae3d27d4eb4full};
+    auto const n = std::size(str);
+    for (std::size_t i = 0; i < n; i += sizeof(std::uint64_t)) {
+        auto word = std::uint64_t{0};
+        std::memcpy(&word, std::data(str) + i, std::min(sizeof(word), n - i));
+        high = mix(high ^ word);
+        low = mix(low + word * 0xff51afd7ed558ccdull);
+    }
+    return { mix(high ^ n), mix(low + high + n) };
+}
+
+template <>
+struct key_hash<Fingerprint> {
+    auto operator()(Fingerprint const& key) const noexcept -> std::size_t {
+        return mix(key.high ^ mix(key.low));
+    }
+};
+
+// The `FingerprintHash<T>` hashes objects to `Fingerprint`s, and can be passed
+// to a `Context` in place of `std::hash<T>`. Strings are supported out of the
+// box. If you are creating a custom type, implement a
+// ```cpp
+// auto fingerprint() const -> Fingerprint;
+// ```
+// method and you are covered.
+template <typename T>
+struct FingerprintHash {
+    auto operator()(T const& x) const noexcept -> Fingerprint {
+        return x.fingerprint();
+    }
+};
+
+template <>
+struct FingerprintHash<std::string> {
+    auto operator()(std::string const& str) const noexcept -> Fingerprint {
+        return fingerprint(str);
+    }
+};
+
+// An `Audited<T, Hash>` hasher wraps another hasher and remembers every
+// distinct object it has seen with each hash, so that it can count the
+// objects which collide with one another. This costs a copy of every distinct
+// object hashed and an ordered map lookup per hash, so it is strictly for
+// measuring how often a given hash would have given a wrong answer — e.g.
+//
+// ```cpp
+// Context<std::string, disassembly_type<std::string>::value, FlatCache, Audited<std::string>> ctx;
+// ctx.assembly_index(str);
+// std::cout << ctx.hasher().collisions() << std::endl;
+// ```
+//
+// Objects are compared with `operator==`, so the type must provide one. Since
+// the hasher allocates, it may throw `std::bad_alloc`, and a `Context` using it
+// lets that propagate to the caller.
+template <typename T, typename Hash = std::hash<T>>
+class Audited {
+    public:
+        using hash_type = std::invoke_result_t<Hash const&, T const&>;
+
+    private:
+        Hash _hash;
+        mutable std::map<hash_type, std::vector<T>> _seen;
+        mutable std::size_t _collisions = 0;
+
+    public:
+        auto operator()(T const& x) const -> hash_type {
+            auto const h = this->_hash(x);
+            auto& objects = this->_seen[h];
+            if (std::find(std::begin(objects), std::end(objects), x) == std::end(objects)) {
+                if (!objects.empty()) {
+                    ++this->_collisions;
+                }
+                objects.push_back(x);
+            }
+            return h;
+        }
+
+        // Get the number of distinct objects which hashed to the same value
+        // as some other object seen before them.
+        auto collisions() const noexcept -> std::size_t {
+            return this->_collisions;
+        }
+
+        // Get the number of distinct objects hashed so far.
+        auto objects() const noexcept -> std::size_t {
+            auto total = std::size_t{0};
+            for (auto const& [h, objects]: this->_seen) {
+                total += std::size(objects);
+            }
+            return total;
+        }
+};
+
+}
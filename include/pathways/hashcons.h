@@ -0,0 +1,300 @@
+#pragma once
+
+#include "pathways.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pathways {
+
+template <typename T, typename Hash>
+class ObjectStore;
+
+template <typename T, typename Hash = typename default_hash<T>::type>
+class Consed;
+
+// A `ConsedDisassembly` lazily turns the IDs of the components which an
+// `ObjectStore` has memoized for an object back into `Consed` handles.
+template <typename T, typename Hash>
+class ConsedDisassembly {
+    private:
+        using ids = std::pair<std::uint32_t, std::uint32_t>;
+
+        ObjectStore<T, Hash> *_store;
+        ids const *_first;
+        ids const *_last;
+
+    public:
+        class const_iterator {
+            private:
+                ObjectStore<T, Hash> *_store;
+                ids const *_parts;
+
+            public:
+                const_iterator(ObjectStore<T, Hash> *store, ids const *parts): _store{store}, _parts{parts} {}
+
+                auto operator++() -> const_iterator& {
+                    ++this->_parts;
+                    return *this;
+                }
+
+                auto operator*() const -> Components<Consed<T, Hash>> {
+                    return { Consed<T, Hash>{this->_store, this->_parts->first},
+                             Consed<T, Hash>{this->_store, this->_parts->second} };
+                }
+
+                auto operator!=(const_iterator const& other) const -> bool {
+                    return this->_parts != other._parts;
+                }
+        };
+
+        ConsedDisassembly(ObjectStore<T, Hash> *store, ids const *first, ids const *last):
+            _store{store}, _first{first}, _last{last} {}
+
+        auto begin() const -> const_iterator {
+            return const_iterator(this->_store, this->_first);
+        }
+
+        auto end() const -> const_iterator {
+            return const_iterator(this->_store, this->_last);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return static_cast<std::size_t>(this->_last - this->_first);
+        }
+};
+
+// A `Consed<T>` is a handle to an object held by an `ObjectStore<T>`. Every
+// structurally identical object interned into a store gets the same handle, so
+// handles are compared and hashed by their dense ID alone, and can be used with
+// a `DenseCache` just like `InternedString`s (see `intern.h`):
+//
+// ```cpp
+// ObjectStore<MyString> store;
+// Context<Consed<MyString>, disassembly_type<Consed<MyString>>::value, DenseCache> ctx;
+// ctx.assembly_index(store.intern(MyString{"0110101110"}));
+// ```
+//
+// The components of a handle's disassembly are themselves handles into the
+// same store, so the store must outlive every handle cut from it.
+template <typename T, typename Hash>
+class Consed {
+    private:
+        ObjectStore<T, Hash> *_store;
+        std::uint32_t _id;
+
+    public:
+        using disassembly_type = ConsedDisassembly<T, Hash>;
+
+        Consed(ObjectStore<T, Hash> *store, std::uint32_t id) noexcept: _store{store}, _id{id} {}
+
+        // Get the object the handle refers to.
+        auto object() const noexcept -> T const& {
+            return this->_store->object(this->_id);
+        }
+
+        // Get the dense ID of the object within its store.
+        auto id() const noexcept -> std::uint32_t {
+            return this->_id;
+        }
+
+        auto is_basic() const -> bool {
+            return this->_store->is_basic(this->_id);
+        }
+
+        auto is_below(Consed const& other) const -> bool {
+            return *this == other || pathways::is_below(this->object(), other.object());
+        }
+
+        auto disassemble() const -> disassembly_type {
+            return this->_store->disassemble(this->_id);
+        }
+
+        friend auto operator==(Consed const& x, Consed const& y) noexcept -> bool {
+            return (x._store == y._store) ? x._id == y._id : x.object() == y.object();
+        }
+
+        friend auto operator!=(Consed const& x, Consed const& y) noexcept -> bool {
+            return !(x == y);
+        }
+};
+
+// An `ObjectStore<T>` hash-conses objects: each structurally identical object
+// is stored exactly once, and `intern` hands out the same `Consed<T>` handle
+// for all of them. The store works with any `T` satisfying the interface in
+// `objects.h`, along with an `operator==`.
+//
+// Beyond deduplicating objects, the store memoizes disassemblies. The first
+// time a handle is disassembled, the object is disassembled and each component
+// is interned, and the IDs of the components are remembered, so every later
+// disassembly of any equal object — e.g. with caching turned off, or in
+// another `Context` sharing the store — is a walk over an array of IDs with no
+// hashing, comparison or copying of objects at all. Each object is hashed
+// with `Hash` only when it is first interned.
+//
+// Interning and disassembling both modify the store, so a store must not be
+// shared between threads.
+template <typename T, typename Hash = typename default_hash<T>::type>
+class ObjectStore {
+    public:
+        using hash_type = std::invoke_result_t<Hash const&, T const&>;
+
+    private:
+        struct Entry {
+            T object;
+            hash_type hash;
+            bool basic;
+            bool disassembled = false;
+            std::vector<std::pair<std::uint32_t, std::uint32_t>> parts = {};
+        };
+
+        static constexpr std::uint32_t empty = std::numeric_limits<std::uint32_t>::max();
+
+        Hash _hash;
+
+        // The `_entries` live in a `std::deque` so that references to them,
+        // and to the objects they hold, remain valid as the store grows.
+        std::deque<Entry> _entries;
+
+        // The `_slots` are an open-addressing index of the entries by hash.
+        std::vector<std::uint32_t> _slots;
+
+        // Find the slot at which the object `x` with hash `h` either resides
+        // or would be inserted.
+        auto probe(T const& x, hash_type const& h) const noexcept -> std::size_t {
+            auto const mask = std::size(this->_slots) - 1;
+            auto i = key_hash<hash_type>{}(h) & mask;
+            while (this->_slots[i] != empty) {
+                auto const& entry = this->_entries[this->_slots[i]];
+                if (entry.hash == h && entry.object == x) {
+                    break;
+                }
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        // Rebuild the index with `capacity` slots.
+        auto rehash(std::size_t capacity) -> void {
+            this->_slots.assign(capacity, empty);
+            auto const mask = capacity - 1;
+            for (std::uint32_t id = 0; id < std::size(this->_entries); ++id) {
+                auto i = key_hash<hash_type>{}(this->_entries[id].hash) & mask;
+                while (this->_slots[i] != empty) {
+                    i = (i + 1) & mask;
+                }
+                this->_slots[i] = id;
+            }
+        }
+
+        // Intern the components of one step of a disassembly, returning their
+        // IDs. A disassembly may yield plain `Components<T>`, or `Prehashed`
+        // components whose hashes are reused if they were computed by the same
+        // kind of hasher as ours (as in `Context::hashed`).
+        auto intern(Components<T>&& parts) -> std::pair<std::uint32_t, std::uint32_t> {
+            auto const x_id = this->intern(std::move(parts.first)).id();
+            auto const y_id = this->intern(std::move(parts.second)).id();
+            return { x_id, y_id };
+        }
+
+        template <typename PrehashedHash>
+        auto intern(Prehashed<T, PrehashedHash>&& parts) -> std::pair<std::uint32_t, std::uint32_t> {
+            if constexpr (std::is_same_v<PrehashedHash, Hash>) {
+                auto const x_id = this->intern(std::move(parts.first), parts.first_hash).id();
+                auto const y_id = this->intern(std::move(parts.second), parts.second_hash).id();
+                return { x_id, y_id };
+            } else {
+                auto const x_id = this->intern(std::move(parts.first)).id();
+                auto const y_id = this->intern(std::move(parts.second)).id();
+                return { x_id, y_id };
+            }
+        }
+
+    public:
+        ObjectStore() = default;
+
+        explicit ObjectStore(Hash hash): _hash{std::move(hash)} {}
+
+        // A store can't be copied or moved, since its handles point to it.
+        ObjectStore(ObjectStore const&) = delete;
+        auto operator=(ObjectStore const&) -> ObjectStore& = delete;
+
+        // Get the handle of an object, storing it if no equal object has been
+        // stored before.
+        auto intern(T x) -> Consed<T, Hash> {
+            auto const h = this->_hash(x);
+            return this->intern(std::move(x), h);
+        }
+
+        // Get the handle of an object whose hash is already known.
+        auto intern(T x, hash_type const& h) -> Consed<T, Hash> {
+            if (2 * (std::size(this->_entries) + 1) > std::size(this->_slots)) {
+                this->rehash(std::max(std::size_t{16}, 2 * std::size(this->_slots)));
+            }
+            auto const i = this->probe(x, h);
+            if (this->_slots[i] == empty) {
+                if (std::size(this->_entries) == empty) {
+                    throw std::length_error("object store is full");
+                }
+                this->_slots[i] = static_cast<std::uint32_t>(std::size(this->_entries));
+                auto const basic = pathways::is_basic(x);
+                this->_entries.push_back(Entry{std::move(x), h, basic});
+            }
+            return { this, this->_slots[i] };
+        }
+
+        // Get the number of distinct objects stored.
+        auto size() const noexcept -> std::size_t {
+            return std::size(this->_entries);
+        }
+
+        // Get the number of component pairs memoized across every disassembly.
+        auto parts() const noexcept -> std::size_t {
+            auto total = std::size_t{0};
+            for (auto const& entry: this->_entries) {
+                total += std::size(entry.parts);
+            }
+            return total;
+        }
+
+        // Get the object with a given ID.
+        auto object(std::uint32_t id) const noexcept -> T const& {
+            return this->_entries[id].object;
+        }
+
+        // Determine whether the object with a given ID is basic.
+        auto is_basic(std::uint32_t id) const noexcept -> bool {
+            return this->_entries[id].basic;
+        }
+
+        // Disassemble the object with a given ID, memoizing the IDs of its
+        // components the first time around.
+        auto disassemble(std::uint32_t id) -> ConsedDisassembly<T, Hash> {
+            if (!this->_entries[id].disassembled) {
+                auto parts = std::vector<std::pair<std::uint32_t, std::uint32_t>>{};
+                for (auto&& step: pathways::disassemble(this->_entries[id].object)) {
+                    parts.push_back(this->intern(std::move(step)));
+                }
+                auto& entry = this->_entries[id];
+                entry.parts = std::move(parts);
+                entry.disassembled = true;
+            }
+            auto const& parts = this->_entries[id].parts;
+            return { this, std::data(parts), std::data(parts) + std::size(parts) };
+        }
+};
+
+}
+
+namespace std {
+    template <typename T, typename Hash> struct hash<pathways::Consed<T, Hash>> {
+        auto operator()(pathways::Consed<T, Hash> const& arg) const noexcept -> std::size_t {
+            return arg.id();
+        }
+    };
+}
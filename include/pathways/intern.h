@@ -0,0 +1,238 @@
+#pragma once
+
+#include "pathways.h"
+#include "search.h"
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pathways {
+
+// A `SuffixAutomaton` is the smallest automaton which accepts exactly the
+// suffixes of a string. Each of its states stands for a set of substrings which
+// end at the same positions in the string: the suffixes of the longest of them
+// whose lengths lie in `(len(link(v)), len(v)]`, where `link(v)` is the state's
+// suffix link. Numbering the substrings of each state consecutively gives every
+// distinct substring of the string a dense ID in `[0, distinct())`.
+//
+// The automaton has at most `2n` states for a string of length `n`, and finds
+// the ID of any substring in `O(log n)` time by jumping up the suffix links from
+// the state reached by the prefix which ends where the substring does.
+class SuffixAutomaton {
+    private:
+        static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        // The `_length` of each state is the length of its longest substring.
+        std::vector<std::size_t> _length;
+
+        // The suffix `_link` of each state, with the root linked to itself.
+        std::vector<std::size_t> _link;
+
+        // The `_first` ID of each state's substrings.
+        std::vector<std::size_t> _first;
+
+        // The state reached by reading the first `i` characters of the string.
+        std::vector<std::size_t> _prefix;
+
+        // The `_ancestors[k][v]` of a state is reached by following `2^k`
+        // suffix links from `v`.
+        std::vector<std::vector<std::size_t>> _ancestors;
+
+        std::size_t _distinct = 0;
+
+    public:
+        SuffixAutomaton() = default;
+
+        explicit SuffixAutomaton(std::string_view str) {
+            // The transitions are only needed to build the automaton, so they are
+            // discarded once it's done.
+            auto next = std::vector<std::map<char, std::size_t>>(1);
+            this->_length.push_back(0);
+            this->_link.push_back(none);
+            this->_prefix.push_back(0);
+
+            auto last = std::size_t{0};
+            for (auto const c: str) {
+                auto const current = std::size(this->_length);
+                this->_length.push_back(this->_length[last] + 1);
+                this->_link.push_back(0);
+                next.emplace_back();
+
+                auto p = last;
+                while (p != none && next[p].count(c) == 0) {
+                    next[p][c] = current;
+                    p = this->_link[p];
+                }
+                if (p != none) {
+                    auto const q = next[p][c];
+                    if (this->_length[p] + 1 == this->_length[q]) {
+                        this->_link[current] = q;
+                    } else {
+                        auto const clone = std::size(this->_length);
+                        this->_length.push_back(this->_length[p] + 1);
+                        this->_link.push_back(this->_link[q]);
+                        auto transitions = next[q];
+                        next.push_back(std::move(transitions));
+                        while (p != none && next[p][c] == q) {
+                            next[p][c] = clone;
+                            p = this->_link[p];
+                        }
+                        this->_link[q] = this->_link[current] = clone;
+                    }
+                }
+                last = current;
+                this->_prefix.push_back(current);
+            }
+            this->_link[0] = 0;
+
+            auto const states = std::size(this->_length);
+            this->_first.resize(states);
+            for (std::size_t v = 1; v < states; ++v) {
+                this->_first[v] = this->_distinct;
+                this->_distinct += this->_length[v] - this->_length[this->_link[v]];
+            }
+
+            this->_ancestors.push_back(this->_link);
+            for (std::size_t span = 2; span <= std::size(str); span <<= 1) {
+                auto const& below = this->_ancestors.back();
+                auto above = std::vector<std::size_t>(states);
+                for (std::size_t v = 0; v < states; ++v) {
+                    above[v] = below[below[v]];
+                }
+                this->_ancestors.push_back(std::move(above));
+            }
+        }
+
+        // Get the number of states in the automaton.
+        auto states() const noexcept -> std::size_t {
+            return std::size(this->_length);
+        }
+
+        // Get the number of distinct (non-empty) substrings of the string.
+        auto distinct() const noexcept -> std::size_t {
+            return this->_distinct;
+        }
+
+        // Get the ID of the `length` characters starting at `offset`, which
+        // must be a non-empty substring of the string.
+        auto id(std::size_t offset, std::size_t length) const noexcept -> std::size_t {
+            auto v = this->_prefix[offset + length];
+            for (auto k = std::size(this->_ancestors); k-- > 0;) {
+                auto const u = this->_ancestors[k][v];
+                if (this->_length[u] >= length) {
+                    v = u;
+                }
+            }
+            return this->_first[v] + (length - this->_length[this->_link[v]] - 1);
+        }
+};
+
+// An `InternedString` is a `Substring`-like view of a window of a root
+// string, whose hash is the window's ID in a `SuffixAutomaton` of the root.
+// Equal substrings have equal IDs wherever they occur, no characters are ever
+// hashed, and the IDs are dense so they can index a `DenseCache` directly:
+//
+// ```cpp
+// Context<InternedString, disassembly_type<InternedString>::value, DenseCache> ctx;
+// ctx.assembly_index(InternedString{"0110101110"});
+// ```
+//
+// IDs are only meaningful relative to their root, so every object passed to a
+// given `Context` must be cut from the same root. In practice this means using
+// a fresh context for each top-level string.
+class InternedString {
+    private:
+        struct Root {
+            std::string str;
+            SuffixAutomaton automaton;
+
+            explicit Root(std::string str): str{std::move(str)}, automaton{this->str} {}
+        };
+
+        std::shared_ptr<Root const> _root;
+        std::size_t _offset;
+        std::size_t _length;
+        std::size_t _id;
+
+        InternedString(std::shared_ptr<Root const> root, std::size_t offset, std::size_t length):
+            _root{std::move(root)},
+            _offset{offset},
+            _length{length},
+            _id{this->_root->automaton.id(offset, length)} {}
+
+    public:
+        using disassembly_type = std::vector<Components<InternedString>>;
+
+        InternedString() = delete;
+
+        InternedString(std::string str) {
+            if (str.empty()) {
+                throw std::invalid_argument("string is empty");
+            }
+            this->_root = std::make_shared<Root const>(std::move(str));
+            this->_offset = 0;
+            this->_length = std::size(this->_root->str);
+            this->_id = this->_root->automaton.id(0, this->_length);
+        }
+
+        InternedString(char const *str): InternedString{std::string(str)} {}
+
+        // Get the characters of the string.
+        auto view() const noexcept -> std::string_view {
+            return std::string_view(this->_root->str).substr(this->_offset, this->_length);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_length;
+        }
+
+        // Get the dense ID of the string within its root.
+        auto id() const noexcept -> std::size_t {
+            return this->_id;
+        }
+
+        // Get the number of distinct substrings of the root, i.e. one more than
+        // the largest ID of any string cut from it.
+        auto distinct() const noexcept -> std::size_t {
+            return this->_root->automaton.distinct();
+        }
+
+        auto is_basic() const -> bool {
+            return this->_length == 1;
+        }
+
+        auto is_below(InternedString const& other) const -> bool {
+            return simd_contains(other.view(), this->view());
+        }
+
+        auto disassemble() const -> disassembly_type {
+            auto parts = disassembly_type{};
+            parts.reserve(this->_length - 1);
+            for (std::size_t i = 1; i < this->_length; ++i) {
+                parts.emplace_back(InternedString{this->_root, this->_offset, i},
+                                   InternedString{this->_root, this->_offset + i, this->_length - i});
+            }
+            return parts;
+        }
+
+        friend auto operator==(InternedString const& x, InternedString const& y) noexcept -> bool {
+            return (x._root == y._root) ? x._id == y._id : x.view() == y.view();
+        }
+
+        friend auto operator!=(InternedString const& x, InternedString const& y) noexcept -> bool {
+            return !(x == y);
+        }
+};
+
+}
+
+namespace std {
+    template <> struct hash<pathways::InternedString> {
+        auto operator()(pathways::InternedString const& arg) const noexcept -> std::size_t {
+            return arg.id();
+        }
+    };
+}
@@ -41,13 +41,35 @@ auto is_below(T const& x, T const& y) -> bool {
     return x.is_below(y);
 }
 
+// The coassembly recursion asks whether `x` is below `y` and, failing that,
+// whether `y` is below `x`. The `relation` function answers both at once, and
+// by default just asks `is_below` twice. It can be specialized for types which
+// can answer both questions more cheaply together, e.g. strings, for which
+// only the shorter string can be below the longer one.
+enum class Relation {
+    below,        // `x` is below `y`
+    above,        // `y` is below `x`, but `x` isn't below `y`
+    incomparable, // neither is below the other
+};
+
+template <typename T>
+auto relation(T const& x, T const& y) -> Relation {
+    if (is_below(x, y)) {
+        return Relation::below;
+    } else if (is_below(y, x)) {
+        return Relation::above;
+    }
+    return Relation::incomparable;
+}
+
 // Third, objects are disassembled into pairs of components. The result of this
 // disassembly process is anything that is iterable and whose iterator can be
-// dereferenced to a `Components<T>` defined below. For example, this function
-// could return an array or vector containing `Components<T>` instances, or it
-// could be an object which can lazily construct those pairs.In order for the
-// algorithms to generalize over this you'll need to tell it what type that
-// will by. Something like
+// dereferenced to a `Components<T>` defined below (or to a `Prehashed<T, Hash>`
+// if it can hash the components as it goes; see `pathways.h`). For example,
+// this function could return an array or vector containing `Components<T>`
+// instances, or it could be an object which can lazily construct those
+// pairs.In order for the algorithms to generalize over this you'll need to
+// tell it what type that will by. Something like
 //
 // ```cpp
 // template<>
@@ -0,0 +1,269 @@
+#pragma once
+
+#include "cache.h"
+#include "pathways.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pathways {
+
+// An alphabet for a `PackedString` names its symbols, in the order of their
+// codes, and the number of bits each code takes.
+struct BinaryAlphabet {
+    static constexpr std::size_t bits = 1;
+    static constexpr char symbols[] = "01";
+};
+
+// The strings in `perf/data` are written in the letters A through D.
+struct QuaternaryAlphabet {
+    static constexpr std::size_t bits = 2;
+    static constexpr char symbols[] = "ABCD";
+};
+
+template <typename Alphabet>
+class PackedDisassembly;
+
+// A `PackedString<Alphabet>` stores a string over a small alphabet as
+// `Alphabet::bits`-bit codes packed into 64-bit words, the first symbol in the
+// lowest bits of the first word. A binary string takes an eighth of the
+// memory of a `std::string`, and a string over A–D a quarter; more usefully,
+// a string of up to 64 binary symbols (or 32 quaternary ones) fits in a single
+// word which is stored inline, so the components of most disassemblies are
+// cut without allocating.
+//
+// Any bits of the last word past the end of the string are zero, so equality
+// and hashing work a word at a time, and `is_below` compares a word's worth of
+// symbols at each position of the longer string rather than one character.
+//
+// ```cpp
+// Context<PackedString<BinaryAlphabet>> ctx;
+// ctx.assembly_index(PackedString<BinaryAlphabet>{"0110101110"});
+// ```
+template <typename Alphabet>
+class PackedString {
+    public:
+        static constexpr std::size_t bits = Alphabet::bits;
+        static constexpr std::size_t per_word = 64 / bits;
+
+        using disassembly_type = PackedDisassembly<Alphabet>;
+
+    private:
+        static_assert(bits == 1 || bits == 2 || bits == 4 || bits == 8, "symbols must evenly divide a word");
+        static_assert(std::size(Alphabet::symbols) - 1 <= (std::size_t{1} << bits), "too many symbols for their codes");
+
+        std::size_t _length = 0;
+        std::uint64_t _inline = 0;
+        std::vector<std::uint64_t> _words;
+
+        PackedString() = default;
+
+        auto data() const noexcept -> std::uint64_t const * {
+            return this->_words.empty() ? &this->_inline : std::data(this->_words);
+        }
+
+        auto words() const noexcept -> std::size_t {
+            return (this->_length * bits + 63) / 64;
+        }
+
+        // Get the `count <= 64` bits which start at bit `offset`.
+        auto bits_at(std::size_t offset, std::size_t count) const noexcept -> std::uint64_t {
+            auto const *word = this->data() + offset / 64;
+            auto const shift = offset % 64;
+            auto value = word[0] >> shift;
+            if (shift != 0 && shift + count > 64) {
+                value |= word[1] << (64 - shift);
+            }
+            return (count == 64) ? value : value & ((std::uint64_t{1} << count) - 1);
+        }
+
+        static auto code(char c) -> std::uint64_t {
+            for (std::size_t i = 0; i + 1 < std::size(Alphabet::symbols); ++i) {
+                if (Alphabet::symbols[i] == c) {
+                    return i;
+                }
+            }
+            throw std::invalid_argument("string has a symbol outside of its alphabet");
+        }
+
+    public:
+        PackedString(std::string_view str): _length{std::size(str)} {
+            if (str.empty()) {
+                throw std::invalid_argument("string is empty");
+            }
+            if (this->_length > per_word) {
+                this->_words.resize(this->words());
+            }
+            auto *word = this->_words.empty() ? &this->_inline : std::data(this->_words);
+            for (std::size_t i = 0; i < this->_length; ++i) {
+                word[i / per_word] |= code(str[i]) << (bits * (i % per_word));
+            }
+        }
+
+        PackedString(std::string const& str): PackedString{std::string_view(str)} {}
+
+        PackedString(char const *str): PackedString{std::string_view(str)} {}
+
+        // Determine whether every character of `str` is in the alphabet.
+        static auto encodes(std::string_view str) noexcept -> bool {
+            return std::all_of(std::begin(str), std::end(str), [](char c) {
+                return std::string_view(Alphabet::symbols).find(c) != std::string_view::npos;
+            });
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_length;
+        }
+
+        // Get the `i`-th symbol.
+        auto operator[](std::size_t i) const noexcept -> char {
+            return Alphabet::symbols[this->bits_at(bits * i, bits)];
+        }
+
+        // Unpack the string.
+        auto str() const -> std::string {
+            auto str = std::string(this->_length, '\0');
+            for (std::size_t i = 0; i < this->_length; ++i) {
+                str[i] = (*this)[i];
+            }
+            return str;
+        }
+
+        // Get the `count` symbols starting at `pos`.
+        auto substr(std::size_t pos, std::size_t count) const -> PackedString {
+            auto sub = PackedString{};
+            sub._length = count;
+            auto const length = count * bits;
+            if (count <= per_word) {
+                sub._inline = this->bits_at(pos * bits, length);
+            } else {
+                sub._words.resize(sub.words());
+                for (std::size_t w = 0; w < std::size(sub._words); ++w) {
+                    sub._words[w] = this->bits_at(pos * bits + 64 * w, std::min(std::size_t{64}, length - 64 * w));
+                }
+            }
+            return sub;
+        }
+
+        auto hash() const noexcept -> std::size_t {
+            auto h = mix(this->_length);
+            auto const *word = this->data();
+            for (std::size_t w = 0, n = this->words(); w < n; ++w) {
+                h = mix(h + word[w]);
+            }
+            return static_cast<std::size_t>(h);
+        }
+
+        auto is_basic() const noexcept -> bool {
+            return this->_length == 1;
+        }
+
+        // Determine whether this string occurs within `other`, comparing up
+        // to a word of symbols at a time at each position of `other`.
+        auto is_below(PackedString const& other) const noexcept -> bool {
+            if (this->_length > other._length) {
+                return false;
+            }
+            auto const length = this->_length * bits;
+            auto const *word = this->data();
+            auto const first = std::min(std::size_t{64}, length);
+            for (std::size_t pos = 0; pos + this->_length <= other._length; ++pos) {
+                auto const offset = pos * bits;
+                if (other.bits_at(offset, first) != word[0]) {
+                    continue;
+                }
+                auto w = std::size_t{1};
+                while (64 * w < length && other.bits_at(offset + 64 * w, std::min(std::size_t{64}, length - 64 * w)) == word[w]) {
+                    ++w;
+                }
+                if (64 * w >= length) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        auto disassemble() const -> disassembly_type {
+            return disassembly_type(*this);
+        }
+
+        friend auto operator==(PackedString const& x, PackedString const& y) noexcept -> bool {
+            return x._length == y._length && std::equal(x.data(), x.data() + x.words(), y.data());
+        }
+
+        friend auto operator!=(PackedString const& x, PackedString const& y) noexcept -> bool {
+            return !(x == y);
+        }
+};
+
+// A `PackedDisassembly` lazily yields the `(head, tail)` pairs of a packed
+// string, from a one-symbol head to a one-symbol tail.
+template <typename Alphabet>
+class PackedDisassembly {
+    private:
+        PackedString<Alphabet> _whole;
+
+    public:
+        class const_iterator {
+            private:
+                PackedString<Alphabet> const *_whole;
+                std::size_t _split;
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = Components<PackedString<Alphabet>>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = value_type;
+
+                const_iterator(PackedString<Alphabet> const *whole, std::size_t split) noexcept: _whole{whole}, _split{split} {}
+
+                auto operator++() noexcept -> const_iterator& {
+                    ++this->_split;
+                    return *this;
+                }
+
+                auto operator*() const -> value_type {
+                    auto const length = std::size(*this->_whole);
+                    return { this->_whole->substr(0, this->_split),
+                             this->_whole->substr(this->_split, length - this->_split) };
+                }
+
+                auto operator==(const_iterator const& other) const noexcept -> bool {
+                    return this->_split == other._split;
+                }
+
+                auto operator!=(const_iterator const& other) const noexcept -> bool {
+                    return !(*this == other);
+                }
+        };
+
+        explicit PackedDisassembly(PackedString<Alphabet> whole): _whole{std::move(whole)} {}
+
+        auto begin() const noexcept -> const_iterator {
+            return const_iterator(&this->_whole, 1);
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return const_iterator(&this->_whole, std::size(this->_whole));
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return std::size(this->_whole) - 1;
+        }
+};
+
+}
+
+namespace std {
+    template <typename Alphabet> struct hash<pathways::PackedString<Alphabet>> {
+        auto operator()(pathways::PackedString<Alphabet> const& arg) const noexcept -> std::size_t {
+            return arg.hash();
+        }
+    };
+}
@@ -1,18 +1,93 @@
 #pragma once
 
+#include "cache.h"
 #include "objects.h"
+#include "statistics.h"
 #include <algorithm>
 #include <cstdint>
-#include <map>
+#include <limits>
 #include <numeric>
 #include <optional>
+#include <type_traits>
 
 namespace pathways {
 
-// We need a type to represent a `Cache` which maps pairs of (hashed) objects
-// to stored value (e.g. the coassembly index between the objects.
-template <typename Store>
-using Cache = std::map<std::pair<std::size_t, std::size_t>, Store>;
+// We need types to represent caches which map (hashed) objects to stored
+// values. An `AssemblyCache` is keyed on single object hashes (e.g. to store
+// the assembly index of the object), while a `CoassemblyCache` is keyed on
+// pairs of hashes (e.g. the coassembly index between the objects). Keeping
+// them apart halves the key size of the assembly entries and keeps them from
+// competing with the far more numerous pairs. The underlying tables are
+// selected by a `CachePolicy`; see `cache.h` for the requirements of a policy
+// and the policies we provide. Hashes are `std::size_t`s by default, but may be
+// any `Key` for which the policy can compute a `key_hash` (e.g. `Fingerprint`s;
+// see `hash.h`).
+template <typename Store, template <typename, typename> class CachePolicy = FlatCache, typename Key = std::size_t>
+using AssemblyCache = CachePolicy<Key, Store>;
+
+template <typename Store, template <typename, typename> class CachePolicy = FlatCache, typename Key = std::size_t>
+using CoassemblyCache = CachePolicy<std::pair<Key, Key>, Store>;
+
+// A `HashedComponents<T>` carries the two components of a disassembly along
+// with their hashes, so that a `Context` hashes each component once per
+// disassembly no matter how many times it looks the component up or stores
+// its (co)assembly index.
+template <typename T, typename Key = std::size_t>
+struct HashedComponents {
+    T const& first;
+    Key first_hash;
+    T const& second;
+    Key second_hash;
+};
+
+// A disassembly which can hash its components more cheaply than hashing them
+// from scratch (e.g. by rolling a hash along a string) may yield
+// `Prehashed<T, Hash>`s rather than `Components<T>`. The hashes must be those
+// a `Hash` would compute. A `Context` which hashes with the same `Hash` takes
+// them as given; any other context ignores them and hashes the components
+// itself.
+template <typename T, typename Hash>
+struct Prehashed {
+    using hash_type = std::invoke_result_t<Hash const&, T const&>;
+
+    T first;
+    hash_type first_hash;
+    T second;
+    hash_type second_hash;
+};
+
+// The `default_hash<T>` trait picks the hasher a `Context<T>` keys its caches
+// with unless it's given another. This is `std::hash<T>` unless specialized,
+// as `string.h` does to hash `std::string`s with `StringHash` (see `simd.h`).
+template <typename T>
+struct default_hash {
+    using type = std::hash<T>;
+};
+
+// A `Retention` policy describes which cached entries a `Context` keeps when
+// it is pruned. Once a top-level `assembly_index(x)` call completes, most of
+// the pairwise coassembly indices it cached are never read again, whereas the
+// assembly indices of small objects are reused by nearly every subsequent
+// call. The cache only stores hashes, so the size of an object is measured by
+// its assembly index — e.g. a string with index `c` has at most `2^c`
+// characters.
+struct Retention {
+    // Whether to keep any coassembly indices at all.
+    bool coassembly = true;
+
+    // Keep only entries whose (co)assembly index is at most `max_index`.
+    uint32_t max_index = std::numeric_limits<uint32_t>::max();
+
+    // Keep the assembly indices, dropping every coassembly index.
+    static auto assembly_only() noexcept -> Retention {
+        return { false, std::numeric_limits<uint32_t>::max() };
+    }
+
+    // Keep only the (co)assembly indices of objects no larger than `max_index`.
+    static auto index_at_most(uint32_t max_index, bool coassembly = true) noexcept -> Retention {
+        return { coassembly, max_index };
+    }
+};
 
 // The `Context<T>` class represents a caching context withing which to compute
 // the assembly and coassembly index of objects.
@@ -25,6 +100,12 @@ using Cache = std::map<std::pair<std::size_t, std::size_t>, Store>;
 // then we'd need want to create a more generic, abstract "Context" type from
 // which to inherit.
 //
+// The storage backing the cache is chosen at compile time by the third
+// template parameter, a `CachePolicy` (see `cache.h`). This defaults to the
+// open-addressing `FlatCache`, but you can swap in any type providing the
+// policy interface — e.g. `MapCache` for the original `std::map`-backed
+// behavior — without paying for virtual dispatch on every cache access.
+//
 // Two other public methods are provided (beyond the boilerplate constructors
 // and assignment operators): `assembly_index` and `coassembly_index`. These
 // methods are (almost) mutually recursive[1]. The details of the
@@ -53,110 +134,210 @@ using Cache = std::map<std::pair<std::size_t, std::size_t>, Store>;
 // Cache size: 23
 // ```
 //
-// [1] There is a protected and overloaded `coassembly_index` method which
-// accepts a pair of objects rather than the objects as separate objects. That
-// function then calls the public `coassembly_index` accordingly.
-template <typename T, typename Disassembly = typename disassembly_type<T>::value>
+// [1] The recursion itself happens in the protected `compute_assembly_index`
+// and `compute_coassembly_index` methods; the public methods call into them
+// and then apply the context's retention policy, if any (see `Retention`).
+// There are also overloads of both which accept objects alongside their
+// precomputed hashes (see `HashedComponents`), and an overloaded
+// `compute_coassembly_index` which accepts a pair of objects rather than the
+// objects as separate objects.
+//
+// Objects are hashed by the fourth template parameter, `Hash`, which defaults
+// to `std::hash<T>` (or whatever `default_hash<T>` says). The caches are keyed
+// on whatever the hasher returns, so passing e.g. `FingerprintHash<T>` keys
+// them on 128-bit `Fingerprint`s (see `hash.h`). The hasher is held by the
+// context and can be inspected with `hasher()`, which lets stateful hashers
+// such as `Audited` report on what they've seen.
+template <typename T,
+          typename Disassembly = typename disassembly_type<T>::value,
+          template <typename, typename> class CachePolicy = FlatCache,
+          typename Hash = typename default_hash<T>::type>
 class Context {
+    public:
+        using key_type = std::invoke_result_t<Hash const&, T const&>;
+        using assembly_cache_type = AssemblyCache<uint32_t, CachePolicy, key_type>;
+        using coassembly_cache_type = CoassemblyCache<uint32_t, CachePolicy, key_type>;
+
     protected:
-        // The `_cache` maps pairs of hashes (of type `std::size`) to `uint32_t` values
-        // representing (co)assembly indicies.
-        Cache<uint32_t> _cache;
+        // Hashing an object may throw (e.g. `Audited` allocates as it goes), in
+        // which case nothing which hashes objects can be `noexcept`.
+        static constexpr bool nothrow_hash = std::is_nothrow_invocable_v<Hash const&, T const&>;
+
+        // The `_hash` function maps objects to cache keys.
+        Hash _hash;
+
+        // The `_assembly_cache` maps object hashes (of type `key_type`) to
+        // `uint32_t` values representing assembly indices.
+        assembly_cache_type _assembly_cache;
+
+        // The `_coassembly_cache` maps pairs of hashes to `uint32_t` values
+        // representing coassembly indices.
+        coassembly_cache_type _coassembly_cache;
+
+        // The `_retention` policy, if any, is applied after every top-level query.
+        std::optional<Retention> _retention;
+
+        // The `_statistics` are only updated when `collect_statistics` is true.
+        Statistics _statistics;
+
+        // Count a cache hit or miss, if statistics are being collected.
+        auto count(std::size_t Statistics::*counter) noexcept -> void {
+            if constexpr (collect_statistics) {
+                ++(this->_statistics.*counter);
+            }
+        }
+
+        // Count an insertion and track the peak size of the caches, if
+        // statistics are being collected.
+        auto count_insert() noexcept -> void {
+            if constexpr (collect_statistics) {
+                ++this->_statistics.inserts;
+                this->_statistics.peak_size = std::max(this->_statistics.peak_size, this->cache_size());
+            }
+        }
 
         // Get the cached value for a given pair of object hashes. The `std::nullopt_t`
         // value is returned if the key is not found.
-        auto cached(std::pair<std::size_t, std::size_t> const& key) const noexcept -> std::optional<uint32_t> {
-            std::optional<uint32_t> cached_value = {};
-            auto const iter = this->_cache.find(key);
-            if (iter != std::end(this->_cache)) {
-                cached_value = iter->second;
-            }
-            return cached_value;
+        auto cached(std::pair<key_type, key_type> const& key) const noexcept -> std::optional<uint32_t> {
+            return this->_coassembly_cache.find(key);
+        }
+
+        // The coassembly index is symmetric in its arguments, so the pair of hashes
+        // `(x_hash, y_hash)` and `(y_hash, x_hash)` should map to the same cache
+        // entry. We ensure this by ordering the hashes before using them as a key.
+        static auto coassembly_key(key_type const& x_hash, key_type const& y_hash) noexcept -> std::pair<key_type, key_type> {
+            return std::minmax(x_hash, y_hash);
         }
 
-        // Get the cached value of two given object hashes. The `std::nullopt_t` value
-        // is returned if the key is not found.
-        auto cached(std::size_t const& x_hash, std::size_t const& y_hash) const noexcept -> std::optional<uint32_t> {
-            return this->cached(std::make_pair(x_hash, y_hash));
+        // Get the cached value of two given object hashes, in either order. The
+        // `std::nullopt_t` value is returned if the key is not found.
+        auto cached(key_type const& x_hash, key_type const& y_hash) const noexcept -> std::optional<uint32_t> {
+            return this->cached(coassembly_key(x_hash, y_hash));
         }
 
         // Get the cached value of two given object. The `std::nullopt_t` value is
         // returned if the key is not found.
-        auto cached(T const& x, T const& y) const noexcept -> std::optional<uint32_t> {
-            auto const x_hash = std::hash<T>{}(x);
-            auto const y_hash = std::hash<T>{}(y);
+        auto cached(T const& x, T const& y) const noexcept(nothrow_hash) -> std::optional<uint32_t> {
+            auto const x_hash = this->hash(x);
+            auto const y_hash = this->hash(y);
 
             return this->cached(x_hash, y_hash);
         }
 
-        // Get the cached value of single given object, stored in the cache as a pair
-        // `(x,x)`. The `std::nullopt_t` value is returned if the key is not found.
-        auto cached(T const& x) const noexcept -> std::optional<uint32_t> {
-            auto const x_hash = std::hash<T>{}(x);
+        // Get the cached value for a single object hash. The `std::nullopt_t` value is
+        // returned if the key is not found.
+        auto cached(key_type const& x_hash) const noexcept -> std::optional<uint32_t> {
+            return this->_assembly_cache.find(x_hash);
+        }
+
+        // Get the cached value of single given object. The `std::nullopt_t` value is
+        // returned if the key is not found.
+        auto cached(T const& x) const noexcept(nothrow_hash) -> std::optional<uint32_t> {
+            auto const x_hash = this->hash(x);
 
-            return this->cached(x_hash, x_hash);
+            return this->cached(x_hash);
         }
 
         // Set the cached value for a pair of object hashes, returning the stored
         // value.
-        auto cache(std::pair<std::size_t, std::size_t> const& key, uint32_t store) noexcept -> uint32_t {
-            return this->_cache[key] = store;
+        auto cache(std::pair<key_type, key_type> const& key, uint32_t store) noexcept -> uint32_t {
+            auto const stored = this->_coassembly_cache.insert(key, store);
+            this->count_insert();
+            return stored;
         }
 
-        // Set the cached value for two given object haches, returning the stored
-        // value.
-        auto cache(std::size_t x_hash, std::size_t y_hash, uint32_t store) noexcept -> uint32_t {
-            return this->cache(std::make_pair(x_hash, y_hash), store);
+        // Set the cached value for two given object haches, in either order,
+        // returning the stored value.
+        auto cache(key_type const& x_hash, key_type const& y_hash, uint32_t store) noexcept -> uint32_t {
+            return this->cache(coassembly_key(x_hash, y_hash), store);
         }
 
         // Set the cached value for two given objects, returning the stored value.
-        auto cache(T const& x, T const& y, uint32_t store) noexcept-> uint32_t {
-            auto const x_hash = std::hash<T>{}(x);
-            auto const y_hash = std::hash<T>{}(y);
+        auto cache(T const& x, T const& y, uint32_t store) noexcept(nothrow_hash) -> uint32_t {
+            auto const x_hash = this->hash(x);
+            auto const y_hash = this->hash(y);
 
             return this->cache(x_hash, y_hash, store);
         }
 
-        // Set the cached value for a single object — treated as a pair `(x,x)` —
-        // returning the stored value.
-        auto cache(T const& x, uint32_t store) noexcept -> uint32_t {
-            auto const x_hash = std::hash<T>{}(x);
+        // Set the cached value for a single object hash, returning the stored value.
+        auto cache(key_type const& x_hash, uint32_t store) noexcept -> uint32_t {
+            auto const stored = this->_assembly_cache.insert(x_hash, store);
+            this->count_insert();
+            return stored;
+        }
+
+        // Set the cached value for a single object, returning the stored value.
+        auto cache(T const& x, uint32_t store) noexcept(nothrow_hash) -> uint32_t {
+            auto const x_hash = this->hash(x);
 
-            return this->cache(x_hash, x_hash, store);
+            return this->cache(x_hash, store);
         }
 
-        // Compute the coassembly index for a pair of objects, optionally caching
-        // intermediate results.
-        auto coassembly_index(std::pair<T const&, T const&> const& objs, bool cache = true) noexcept -> uint32_t {
-            return this->coassembly_index(std::get<0>(objs), std::get<1>(objs), cache);
+        // Hash an object for use as (part of) a cache key.
+        auto hash(T const& x) const noexcept(nothrow_hash) -> key_type {
+            return this->_hash(x);
         }
 
-    public:
-        Context() = default;
-        Context(Context<T, Disassembly> const&) = delete;
-        Context(Context<T, Disassembly>&&) = default;
+        // Pair up the components of a disassembly with their hashes. Basic
+        // components are never looked up in the cache, so they are only hashed
+        // when caching is enabled and they are not basic.
+        auto hashed(Components<T> const& parts, bool cache) const noexcept(nothrow_hash) -> HashedComponents<T, key_type> {
+            auto const& [x, y] = parts;
+            auto const x_hash = (cache && !pathways::is_basic(x)) ? this->hash(x) : key_type{};
+            auto const y_hash = (cache && !pathways::is_basic(y)) ? this->hash(y) : key_type{};
+            return { x, x_hash, y, y_hash };
+        }
 
-        auto operator=(Context<T, Disassembly> const&) -> Context<T, Disassembly>& = delete;
-        auto operator=(Context<T, Disassembly>&&) -> Context<T, Disassembly>& = default;
+        // Pair up prehashed components with their hashes. The hashes are only
+        // used if they were computed by the same kind of hasher as ours.
+        template <typename PrehashedHash>
+        auto hashed(Prehashed<T, PrehashedHash> const& parts, bool cache) const noexcept(nothrow_hash) -> HashedComponents<T, key_type> {
+            if constexpr (std::is_same_v<PrehashedHash, Hash>) {
+                return { parts.first, parts.first_hash, parts.second, parts.second_hash };
+            } else {
+                auto const x_hash = (cache && !pathways::is_basic(parts.first)) ? this->hash(parts.first) : key_type{};
+                auto const y_hash = (cache && !pathways::is_basic(parts.second)) ? this->hash(parts.second) : key_type{};
+                return { parts.first, x_hash, parts.second, y_hash };
+            }
+        }
 
-        // Get the number of pairs stored in the cache.
-        auto cache_size() const noexcept -> std::size_t {
-            return std::size(this->_cache);
+        // Compute the coassembly index for a pair of objects, optionally caching
+        // intermediate results.
+        auto compute_coassembly_index(std::pair<T const&, T const&> const& objs, bool cache) noexcept(nothrow_hash) -> uint32_t {
+            return this->compute_coassembly_index(std::get<0>(objs), std::get<1>(objs), cache);
+        }
+
+        // Compute the coassembly index for a pair of objects whose hashes have
+        // already been computed.
+        auto compute_coassembly_index(HashedComponents<T, key_type> const& parts, bool cache) noexcept(nothrow_hash) -> uint32_t {
+            return this->compute_coassembly_index(parts.first, parts.first_hash, parts.second, parts.second_hash, cache);
         }
 
         // Compute the assembly index of an object. Optionally, you can turn on or off
         // caching with the `cache` argument.
-        auto assembly_index(T const& x, bool cache = true) noexcept -> uint32_t {
+        auto compute_assembly_index(T const& x, bool cache) noexcept(nothrow_hash) -> uint32_t {
+            auto const x_hash = (cache && !pathways::is_basic(x)) ? this->hash(x) : key_type{};
+            return this->compute_assembly_index(x, x_hash, cache);
+        }
+
+        // Compute the assembly index of an object given its hash, which is ignored
+        // if `cache` is false. Each component of the object's disassembly is hashed
+        // exactly once, and that hash is used for every lookup and insertion
+        // involving the component during this step of the recursion.
+        auto compute_assembly_index(T const& x, key_type const& x_hash, bool cache) noexcept(nothrow_hash) -> uint32_t {
             if (pathways::is_basic(x)) {
                 // If `x` is a basic object, it's assembly index is 0 by definition.
                 return 0;
             } else if (cache) {
                 // If `cache` is true, we try to find the object `x` in the cache. If that's
                 // successful, we return the cached assembly index.
-                auto const c = this->cached(x);
+                auto const c = this->cached(x_hash);
                 if (c) {
+                    this->count(&Statistics::assembly_hits);
                     return c.value();
                 }
+                this->count(&Statistics::assembly_misses);
             }
 
             // In the case we have not yet computed the assembly index for the object, or
@@ -168,36 +349,46 @@ class Context {
             // together to produce the original. We then compute the smallest coassembly
             // index of each pair — plus 1 to account for the final joinging operation
             // which yields the original object.
-            for (pathways::Components<T> const& parts: pathways::disassemble(x)) {
-                auto const cc = this->coassembly_index(parts, cache);
+            for (auto const& parts: pathways::disassemble(x)) {
+                auto const cc = this->compute_coassembly_index(hashed(parts, cache), cache);
                 c = std::min(c, cc + 1);
             }
 
             // Cache and return the result if we want, otherwise just return it.
             if (cache) {
-                return this->cache(x, c);
+                return this->cache(x_hash, c);
             } else {
                 return c;
             }
         }
 
         // *Estimate* the coassembly index of two objects. As with the
-        // `assembly_index`, you can optionally turn on or off caching with the `cache`
-        // argument.
-        auto coassembly_index(T const& x, T const& y, bool cache = true) noexcept -> uint32_t {
+        // `compute_assembly_index`, you can optionally turn on or off caching with
+        // the `cache` argument.
+        auto compute_coassembly_index(T const& x, T const& y, bool cache) noexcept(nothrow_hash) -> uint32_t {
+            auto const x_hash = (cache && !pathways::is_basic(x)) ? this->hash(x) : key_type{};
+            auto const y_hash = (cache && !pathways::is_basic(y)) ? this->hash(y) : key_type{};
+            return this->compute_coassembly_index(x, x_hash, y, y_hash, cache);
+        }
+
+        // *Estimate* the coassembly index of two objects given their hashes, which
+        // are ignored if `cache` is false.
+        auto compute_coassembly_index(T const& x, key_type const& x_hash, T const& y, key_type const& y_hash, bool cache) noexcept(nothrow_hash) -> uint32_t {
             if (pathways::is_basic(x)) {
                 // If the *first* object is basic, return the *second* object's assembly index.
-                return this->assembly_index(y, cache);
+                return this->compute_assembly_index(y, y_hash, cache);
             } else if (pathways::is_basic(y)) {
                 // If the *second* object is basic, return the *first* object's assembly index.
-                return this->assembly_index(x, cache);
+                return this->compute_assembly_index(x, x_hash, cache);
             } else if (cache) {
                 // If `cache` is true, we try to find the pair of objects `(x, y)` in the
                 // cache. If that's successful, we return the cached assembly index.
-                auto const cc = this->cached(x, y);
+                auto const cc = this->cached(x_hash, y_hash);
                 if (cc) {
+                    this->count(&Statistics::coassembly_hits);
                     return cc.value();
                 }
+                this->count(&Statistics::coassembly_misses);
             }
 
             // In the case we have not yet computed the coassembly index for the object, or
@@ -208,30 +399,181 @@ class Context {
             // The following are simple approximations which *should* be replaced with
             // a more robust algorithm. However, it seems the approximation is pretty
             // reasonable give a toy system (binary string).
-            if (pathways::is_below(x, y)) {
-                // If the *first* object is less than or equal to the *second* object,
-                // approximate the coassembly index as the assembly index of the *second*
-                // object.
-                cc = this->assembly_index(y, cache);
-            } else if (pathways::is_below(y, x)) {
-                // If the *second* object is less than or equal to the *first* object,
-                // approximate the coassembly index as the assembly index of the *first*
-                // object.
-                cc = this->assembly_index(x, cache);
-            } else {
-                // If the objects are incomparable, assume they share no substructures in
-                // common, and approximate the coassembly index as the sum of the assembly
-                // indices of each object.
-                cc = this->assembly_index(x, cache) + this->assembly_index(y, cache);
+            switch (pathways::relation(x, y)) {
+                case Relation::below:
+                    // If the *first* object is less than or equal to the *second* object,
+                    // approximate the coassembly index as the assembly index of the *second*
+                    // object.
+                    cc = this->compute_assembly_index(y, y_hash, cache);
+                    break;
+                case Relation::above:
+                    // If the *second* object is less than or equal to the *first* object,
+                    // approximate the coassembly index as the assembly index of the *first*
+                    // object.
+                    cc = this->compute_assembly_index(x, x_hash, cache);
+                    break;
+                case Relation::incomparable:
+                    // If the objects are incomparable, assume they share no substructures in
+                    // common, and approximate the coassembly index as the sum of the assembly
+                    // indices of each object.
+                    cc = this->compute_assembly_index(x, x_hash, cache) + this->compute_assembly_index(y, y_hash, cache);
+                    break;
             }
 
             // Cache and return the result if we want, otherwise just return it.
             if (cache) {
-                return this->cache(x, y, cc);
+                return this->cache(x_hash, y_hash, cc);
             } else {
                 return cc;
             }
         }
+
+    public:
+        Context() = default;
+
+        // Construct a context around already configured caches, e.g. to size or
+        // bound the two tables independently, and optionally a configured hasher.
+        explicit Context(assembly_cache_type assembly_cache, coassembly_cache_type coassembly_cache = {}, Hash hash = {}):
+            _hash{std::move(hash)},
+            _assembly_cache{std::move(assembly_cache)},
+            _coassembly_cache{std::move(coassembly_cache)} {}
+
+        Context(Context const&) = delete;
+        Context(Context&&) = default;
+
+        auto operator=(Context const&) -> Context& = delete;
+        auto operator=(Context&&) -> Context& = default;
+
+        // Get the total number of objects and pairs stored in the cache.
+        auto cache_size() const noexcept -> std::size_t {
+            return this->assembly_cache_size() + this->coassembly_cache_size();
+        }
+
+        // Get the number of single objects whose assembly index is cached.
+        auto assembly_cache_size() const noexcept -> std::size_t {
+            return this->_assembly_cache.size();
+        }
+
+        // Get the number of pairs whose coassembly index is cached.
+        auto coassembly_cache_size() const noexcept -> std::size_t {
+            return this->_coassembly_cache.size();
+        }
+
+        // Get the number of entries the caches have evicted to stay within
+        // their bounds. This is always zero for unbounded cache policies.
+        auto cache_evictions() const noexcept -> std::size_t {
+            return this->_assembly_cache.evictions() + this->_coassembly_cache.evictions();
+        }
+
+        // Get the hasher used to key the caches.
+        auto hasher() const noexcept -> Hash const& {
+            return this->_hash;
+        }
+
+        // Get the cache of assembly indices, e.g. to freeze it (see `frozen.h`).
+        auto assembly_cache() const noexcept -> assembly_cache_type const& {
+            return this->_assembly_cache;
+        }
+
+        // Get the cache of coassembly indices.
+        auto coassembly_cache() const noexcept -> coassembly_cache_type const& {
+            return this->_coassembly_cache;
+        }
+
+        // Get the number of slots allocated by the caches.
+        auto cache_capacity() const noexcept -> std::size_t {
+            return this->_assembly_cache.capacity() + this->_coassembly_cache.capacity();
+        }
+
+        // Get the cache statistics gathered so far, along with the memory the
+        // caches currently occupy and their combined probe-length histogram.
+        // The counters are only maintained when the library is built with
+        // `PATHWAYS_STATISTICS` defined; otherwise they are all zero.
+        auto statistics() const -> Statistics {
+            auto stats = this->_statistics;
+            stats.bytes = this->_assembly_cache.bytes() + this->_coassembly_cache.bytes();
+            stats.probe_lengths = this->_assembly_cache.probe_lengths();
+            stats.probe_lengths += this->_coassembly_cache.probe_lengths();
+            return stats;
+        }
+
+        // Drop every cached entry which the `retention` policy does not keep,
+        // returning the number of entries dropped.
+        auto prune(Retention const& retention) -> std::size_t {
+            auto const max_index = retention.max_index;
+            auto const above = [max_index](auto const&, uint32_t index) { return index > max_index; };
+
+            auto pruned = std::size_t{0};
+            if (max_index != std::numeric_limits<uint32_t>::max()) {
+                pruned += this->_assembly_cache.erase_if(above);
+            }
+            if (!retention.coassembly) {
+                pruned += this->_coassembly_cache.size();
+                this->_coassembly_cache.clear();
+            } else if (max_index != std::numeric_limits<uint32_t>::max()) {
+                pruned += this->_coassembly_cache.erase_if(above);
+            }
+            return pruned;
+        }
+
+        // Get the retention policy applied after each top-level query, if any.
+        auto retention() const noexcept -> std::optional<Retention> const& {
+            return this->_retention;
+        }
+
+        // Set the retention policy applied after each top-level query. Pass
+        // `std::nullopt` to keep everything.
+        auto retention(std::optional<Retention> retention) noexcept -> void {
+            this->_retention = std::move(retention);
+        }
+
+        // Pre-size the caches to hold at least `objects` assembly indices and
+        // `pairs` coassembly indices without rehashing.
+        auto reserve(std::size_t objects, std::size_t pairs) -> void {
+            this->_assembly_cache.reserve(objects);
+            this->_coassembly_cache.reserve(pairs);
+        }
+
+        // Compute the assembly index of an object. Optionally, you can turn on or off
+        // caching with the `cache` argument. If a retention policy is set, the cache
+        // is pruned once the index has been computed. Pruning rehashes the cache, so
+        // this may throw `std::bad_alloc`.
+        auto assembly_index(T const& x, bool cache = true) -> uint32_t {
+            auto const c = this->compute_assembly_index(x, cache);
+            if (cache && this->_retention) {
+                this->prune(this->_retention.value());
+            }
+            return c;
+        }
+
+        // *Estimate* the coassembly index of two objects. As with the
+        // `assembly_index`, you can optionally turn on or off caching with the `cache`
+        // argument, and the cache is pruned afterwards if a retention policy is set
+        // (which may throw `std::bad_alloc`, as for `assembly_index`).
+        auto coassembly_index(T const& x, T const& y, bool cache = true) -> uint32_t {
+            auto const cc = this->compute_coassembly_index(x, y, cache);
+            if (cache && this->_retention) {
+                this->prune(this->_retention.value());
+            }
+            return cc;
+        }
 };
 
+// A `BoundedContext<T>` never caches more than a fixed number of objects and
+// pairs, so long computations run in bounded memory at the expense of
+// recomputing evicted (co)assembly indices. The two caches are bounded
+// separately, so you can reserve a generous budget for the assembly indices,
+// and let them outlast more sweeps of the eviction clock, while the pairs
+// churn.
+//
+// ```cpp
+// using Ctx = BoundedContext<std::string>;
+// auto ctx = Ctx{
+//     Ctx::assembly_cache_type::with_memory(1 << 28, 3),
+//     Ctx::coassembly_cache_type::with_memory(1 << 30)
+// };
+// ```
+template <typename T, typename Disassembly = typename disassembly_type<T>::value, typename Hash = typename default_hash<T>::type>
+using BoundedContext = Context<T, Disassembly, BoundedCache, Hash>;
+
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "objects.h"
+#include "simd.h"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace pathways {
+
+namespace simd {
+
+// Determine whether the `k` characters at `s` occur within the `n` characters
+// at `h`, where `2 <= k <= n`.
+using Search = bool (*)(char const *h, std::size_t n, char const *s, std::size_t k);
+
+inline auto contains_scalar(char const *h, std::size_t n, char const *s, std::size_t k) -> bool {
+    return std::string_view(h, n).find(std::string_view(s, k)) != std::string_view::npos;
+}
+
+#ifdef PATHWAYS_X86_DISPATCH
+// The vectorized kernels compare a block of candidate positions at once
+// against both the first and the last character of the needle, and only
+// compare the characters in between at the positions where both match. The
+// positions too close to the end of the haystack for a full block are left to
+// the scalar kernel.
+__attribute__((target("sse2")))
+inline auto contains_sse(char const *h, std::size_t n, char const *s, std::size_t k) -> bool {
+    auto const first = _mm_set1_epi8(s[0]);
+    auto const last = _mm_set1_epi8(s[k - 1]);
+    auto i = std::size_t{0};
+    for (; i + k + 15 <= n; i += 16) {
+        auto const block_first = _mm_loadu_si128(reinterpret_cast<__m128i const *>(h + i));
+        auto const block_last = _mm_loadu_si128(reinterpret_cast<__m128i const *>(h + i + k - 1));
+        auto const eq = _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+        while (mask != 0) {
+            auto const j = static_cast<std::size_t>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + j + 1, s + 1, k - 2) == 0) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return contains_scalar(h + i, n - i, s, k);
+}
+
+__attribute__((target("avx2")))
+inline auto contains_avx2(char const *h, std::size_t n, char const *s, std::size_t k) -> bool {
+    auto const first = _mm256_set1_epi8(s[0]);
+    auto const last = _mm256_set1_epi8(s[k - 1]);
+    auto i = std::size_t{0};
+    for (; i + k + 31 <= n; i += 32) {
+        auto const block_first = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(h + i));
+        auto const block_last = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(h + i + k - 1));
+        auto const eq = _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+        while (mask != 0) {
+            auto const j = static_cast<std::size_t>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + j + 1, s + 1, k - 2) == 0) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return contains_sse(h + i, n - i, s, k);
+}
+#endif
+
+// Get the search kernel for a given instruction set, falling back as `kernel`
+// does when the CPU doesn't support it.
+inline auto search_kernel(HashKernel which) noexcept -> Search {
+#ifdef PATHWAYS_X86_DISPATCH
+    switch (which) {
+        case HashKernel::avx2:
+            if (__builtin_cpu_supports("avx2")) {
+                return contains_avx2;
+            }
+            [[fallthrough]];
+        case HashKernel::sse:
+            if (__builtin_cpu_supports("sse2")) {
+                return contains_sse;
+            }
+            [[fallthrough]];
+        case HashKernel::scalar:
+            break;
+    }
+#else
+    static_cast<void>(which);
+#endif
+    return contains_scalar;
+}
+
+// The search kernel for this CPU, resolved once at startup.
+inline Search const search = search_kernel(dispatched);
+
+}
+
+// Determine whether `needle` occurs within `haystack`, searching with the
+// fastest kernel available on this CPU.
+inline auto simd_contains(std::string_view haystack, std::string_view needle) noexcept -> bool {
+    auto const k = std::size(needle);
+    auto const n = std::size(haystack);
+    if (k > n) {
+        return false;
+    } else if (k < 2) {
+        return k == 0 || haystack.find(needle[0]) != std::string_view::npos;
+    }
+    return simd::search(std::data(haystack), n, std::data(needle), k);
+}
+
+// Determine whether `needle` occurs within `haystack` with a particular kernel
+// (see `simd::search_kernel`), e.g. to test the kernels against one another.
+inline auto simd_contains(std::string_view haystack, std::string_view needle, simd::Search kernel) noexcept -> bool {
+    auto const k = std::size(needle);
+    auto const n = std::size(haystack);
+    if (k > n) {
+        return false;
+    } else if (k < 2) {
+        return k == 0 || haystack.find(needle[0]) != std::string_view::npos;
+    }
+    return kernel(std::data(haystack), n, std::data(needle), k);
+}
+
+// Relate two strings with a single search: only the shorter string can occur
+// within the longer one, and strings of the same length only occur within one
+// another if they're equal, in which case `x` is reported below `y`.
+inline auto string_relation(std::string_view x, std::string_view y) noexcept -> Relation {
+    if (std::size(x) <= std::size(y)) {
+        return simd_contains(y, x) ? Relation::below : Relation::incomparable;
+    }
+    return simd_contains(x, y) ? Relation::above : Relation::incomparable;
+}
+
+}
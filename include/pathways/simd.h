@@ -0,0 +1,250 @@
+#pragma once
+
+#include "cache.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PATHWAYS_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace pathways {
+
+// The hash kernels which `simd_hash` can dispatch to. Every kernel computes
+// exactly the same hash, so which one runs only affects how quickly it's
+// computed — caches filled on one machine agree with caches filled on another.
+enum class HashKernel {
+    scalar,
+    sse,
+    avx2,
+};
+
+namespace simd {
+
+// The secrets mixed into each of the four 64-bit lanes of the accumulator,
+// along with the amount added to each secret per 32-byte stripe. Varying the
+// secrets between stripes means that permuting the stripes of a string
+// changes its hash.
+constexpr std::uint64_t secret[8] = {
+    0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+    0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull,
+};
+constexpr std::uint64_t step = 0x9e3779b97f4a7c15ull;
+constexpr std::size_t stripe = 32;
+
+inline auto read32(char const *p) noexcept -> std::uint64_t {
+    auto word = std::uint32_t{0};
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+inline auto read64(char const *p) noexcept -> std::uint64_t {
+    auto word = std::uint64_t{0};
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Multiply two words and fold the 128-bit product into 64 bits.
+inline auto fold(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+    __extension__ using uint128 = unsigned __int128;
+    auto const product = static_cast<uint128>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+}
+
+// Fold the four lanes of an accumulator, and the length of the string, into
+// the final hash.
+inline auto finish(std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t d, std::size_t n) noexcept -> std::uint64_t {
+    return mix(fold(a ^ secret[0], b ^ secret[1]) + fold(c ^ secret[2], d ^ secret[3]) + n * step);
+}
+
+// Hash the `n > 32` bytes starting at `p` by accumulating them into four
+// 64-bit lanes, which start out as `secret[4]` through `secret[7]`. The
+// full stripes are accumulated first, and the last 32 bytes are accumulated
+// as one more (overlapping) stripe so that the tail never needs padding. Each
+// lane `l` of the `s`-th stripe `d` updates
+//
+//     acc[l] += d[l ^ 1] + lo32(d[l] ^ key[l]) * hi32(d[l] ^ key[l])
+//
+// where `key[l] = secret[l] + s * step`. This only needs the 32 × 32 → 64-bit
+// multiplies that SSE2 and AVX2 provide.
+using Kernel = std::uint64_t (*)(char const *p, std::size_t n);
+
+inline auto accumulate_scalar(char const *p, std::size_t n) -> std::uint64_t {
+    std::uint64_t acc[4] = { secret[4], secret[5], secret[6], secret[7] };
+    auto const full = (n - 1) / stripe;
+    for (std::size_t s = 0; s <= full; ++s) {
+        std::uint64_t data[4];
+        std::memcpy(data, (s < full) ? p + s * stripe : p + n - stripe, stripe);
+        for (std::size_t l = 0; l < 4; ++l) {
+            auto const key = data[l] ^ (secret[l] + s * step);
+            acc[l] += data[l ^ 1] + (key & 0xffffffffull) * (key >> 32);
+        }
+    }
+    return finish(acc[0], acc[1], acc[2], acc[3], n);
+}
+
+#ifdef PATHWAYS_X86_DISPATCH
+__attribute__((target("sse2")))
+inline auto accumulate_sse(char const *p, std::size_t n) -> std::uint64_t {
+    auto lo = _mm_set_epi64x(static_cast<long long>(secret[5]), static_cast<long long>(secret[4]));
+    auto hi = _mm_set_epi64x(static_cast<long long>(secret[7]), static_cast<long long>(secret[6]));
+    auto const delta = _mm_set1_epi64x(static_cast<long long>(step));
+    auto key_lo = _mm_set_epi64x(static_cast<long long>(secret[1]), static_cast<long long>(secret[0]));
+    auto key_hi = _mm_set_epi64x(static_cast<long long>(secret[3]), static_cast<long long>(secret[2]));
+    auto const full = (n - 1) / stripe;
+    for (std::size_t s = 0; s <= full; ++s) {
+        auto const q = (s < full) ? p + s * stripe : p + n - stripe;
+        auto const data_lo = _mm_loadu_si128(reinterpret_cast<__m128i const *>(q));
+        auto const data_hi = _mm_loadu_si128(reinterpret_cast<__m128i const *>(q + 16));
+        auto const keyed_lo = _mm_xor_si128(data_lo, key_lo);
+        auto const keyed_hi = _mm_xor_si128(data_hi, key_hi);
+        lo = _mm_add_epi64(lo, _mm_shuffle_epi32(data_lo, _MM_SHUFFLE(1, 0, 3, 2)));
+        hi = _mm_add_epi64(hi, _mm_shuffle_epi32(data_hi, _MM_SHUFFLE(1, 0, 3, 2)));
+        lo = _mm_add_epi64(lo, _mm_mul_epu32(keyed_lo, _mm_srli_epi64(keyed_lo, 32)));
+        hi = _mm_add_epi64(hi, _mm_mul_epu32(keyed_hi, _mm_srli_epi64(keyed_hi, 32)));
+        key_lo = _mm_add_epi64(key_lo, delta);
+        key_hi = _mm_add_epi64(key_hi, delta);
+    }
+    return finish(static_cast<std::uint64_t>(_mm_cvtsi128_si64(lo)),
+                  static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(lo, lo))),
+                  static_cast<std::uint64_t>(_mm_cvtsi128_si64(hi)),
+                  static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(hi, hi))), n);
+}
+
+__attribute__((target("avx2")))
+inline auto accumulate_avx2(char const *p, std::size_t n) -> std::uint64_t {
+    auto sum = _mm256_set_epi64x(static_cast<long long>(secret[7]), static_cast<long long>(secret[6]),
+                                 static_cast<long long>(secret[5]), static_cast<long long>(secret[4]));
+    auto const delta = _mm256_set1_epi64x(static_cast<long long>(step));
+    auto key = _mm256_set_epi64x(static_cast<long long>(secret[3]), static_cast<long long>(secret[2]),
+                                 static_cast<long long>(secret[1]), static_cast<long long>(secret[0]));
+    auto const full = (n - 1) / stripe;
+    for (std::size_t s = 0; s <= full; ++s) {
+        auto const q = (s < full) ? p + s * stripe : p + n - stripe;
+        auto const data = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(q));
+        auto const keyed = _mm256_xor_si256(data, key);
+        sum = _mm256_add_epi64(sum, _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm256_add_epi64(sum, _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32)));
+        key = _mm256_add_epi64(key, delta);
+    }
+    auto const lo = _mm256_castsi256_si128(sum);
+    auto const hi = _mm256_extracti128_si256(sum, 1);
+    return finish(static_cast<std::uint64_t>(_mm_cvtsi128_si64(lo)),
+                  static_cast<std::uint64_t>(_mm_extract_epi64(lo, 1)),
+                  static_cast<std::uint64_t>(_mm_cvtsi128_si64(hi)),
+                  static_cast<std::uint64_t>(_mm_extract_epi64(hi, 1)), n);
+}
+#endif
+
+// Get the fastest kernel the CPU we're running on supports. SSE2 is part of
+// x86-64, so the scalar kernel is only used on other architectures.
+inline auto best_kernel() noexcept -> HashKernel {
+#ifdef PATHWAYS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return HashKernel::avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return HashKernel::sse;
+    }
+#endif
+    return HashKernel::scalar;
+}
+
+// Get the accumulator for a given kernel, falling back to the scalar kernel if
+// the CPU doesn't support it.
+inline auto kernel(HashKernel which) noexcept -> Kernel {
+#ifdef PATHWAYS_X86_DISPATCH
+    switch (which) {
+        case HashKernel::avx2:
+            if (__builtin_cpu_supports("avx2")) {
+                return accumulate_avx2;
+            }
+            [[fallthrough]];
+        case HashKernel::sse:
+            if (__builtin_cpu_supports("sse2")) {
+                return accumulate_sse;
+            }
+            [[fallthrough]];
+        case HashKernel::scalar:
+            break;
+    }
+#else
+    static_cast<void>(which);
+#endif
+    return accumulate_scalar;
+}
+
+// The kernel chosen for this CPU, resolved once at startup.
+inline HashKernel const dispatched = best_kernel();
+inline Kernel const accumulate = kernel(dispatched);
+
+// Hash strings of at most 32 bytes, for which setting up the lanes would cost
+// more than it saves. Each length class reads the string as a few (possibly
+// overlapping) words, so no byte is read twice within a word and none is
+// skipped.
+inline auto hash_short(char const *p, std::size_t n) noexcept -> std::uint64_t {
+    if (n > 16) {
+        auto const a = fold(read64(p) ^ secret[0], read64(p + 8) ^ secret[1]);
+        auto const b = fold(read64(p + n - 16) ^ secret[2], read64(p + n - 8) ^ secret[3]);
+        return mix(a + b + n * secret[4]);
+    } else if (n > 8) {
+        return mix(fold(read64(p) ^ secret[5], read64(p + n - 8) ^ secret[6]) + n);
+    } else if (n >= 4) {
+        auto const word = (read32(p) << 32) | read32(p + n - 4);
+        return mix(fold(word ^ secret[7], n + secret[0]));
+    } else if (n > 0) {
+        auto const c0 = static_cast<std::uint64_t>(static_cast<unsigned char>(p[0]));
+        auto const c1 = static_cast<std::uint64_t>(static_cast<unsigned char>(p[n >> 1]));
+        auto const c2 = static_cast<std::uint64_t>(static_cast<unsigned char>(p[n - 1]));
+        return mix(((c0 << 16) | (c1 << 24) | c2 | (n << 8)) ^ secret[1]);
+    }
+    return mix(secret[2]);
+}
+
+}
+
+// Hash a string with the fastest kernel available on this CPU. Strings of up
+// to 32 bytes — most of the substrings of the strings we assemble — are
+// hashed inline with a handful of loads and multiplies; longer strings are
+// hashed 32 bytes at a time by an AVX2, SSE or scalar kernel, chosen once at
+// startup.
+inline auto simd_hash(std::string_view str) noexcept -> std::uint64_t {
+    auto const n = std::size(str);
+    if (n <= simd::stripe) {
+        return simd::hash_short(std::data(str), n);
+    }
+    return simd::accumulate(std::data(str), n);
+}
+
+// Hash a string with a particular kernel (see `simd::kernel`), e.g. to
+// benchmark the kernels against one another.
+inline auto simd_hash(std::string_view str, simd::Kernel kernel) noexcept -> std::uint64_t {
+    auto const n = std::size(str);
+    if (n <= simd::stripe) {
+        return simd::hash_short(std::data(str), n);
+    }
+    return kernel(std::data(str), n);
+}
+
+// Get the kernel `simd_hash` dispatches to on this CPU.
+inline auto hash_kernel() noexcept -> HashKernel {
+    return simd::dispatched;
+}
+
+// The `StringHash` hasher hashes strings with `simd_hash`, and can be passed to
+// a `Context` in place of `std::hash<std::string>`.
+struct StringHash {
+    auto operator()(std::string_view str) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(simd_hash(str));
+    }
+
+    auto operator()(std::string const& str) const noexcept -> std::size_t {
+        return static_cast<std::size_t>(simd_hash(str));
+    }
+};
+
+}
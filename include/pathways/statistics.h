@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+
+namespace pathways {
+
+// Cache statistics are only collected when `PATHWAYS_STATISTICS` is defined,
+// e.g. by building with `make STATS=1`. Otherwise, the counters are never
+// touched and cost nothing on the hot path.
+#ifdef PATHWAYS_STATISTICS
+constexpr bool collect_statistics = true;
+#else
+constexpr bool collect_statistics = false;
+#endif
+
+// A `ProbeHistogram` counts how far lookups and insertions into an
+// open-addressing table had to probe past a key's home slot. The last bin
+// collects every probe of `bins - 1` or more slots.
+class ProbeHistogram {
+    public:
+        static constexpr std::size_t bins = 16;
+
+    private:
+        std::array<std::size_t, bins> _counts = {};
+
+    public:
+        auto record(std::size_t distance) noexcept -> void {
+            ++this->_counts[distance < bins ? distance : bins - 1];
+        }
+
+        auto operator[](std::size_t bin) const noexcept -> std::size_t {
+            return this->_counts[bin];
+        }
+
+        auto total() const noexcept -> std::size_t {
+            auto total = std::size_t{0};
+            for (auto const count: this->_counts) {
+                total += count;
+            }
+            return total;
+        }
+
+        auto operator+=(ProbeHistogram const& other) noexcept -> ProbeHistogram& {
+            for (std::size_t i = 0; i < bins; ++i) {
+                this->_counts[i] += other._counts[i];
+            }
+            return *this;
+        }
+};
+
+// The `Statistics` of a `Context` describe how well its caches are working:
+// how often assembly and coassembly lookups hit, how many entries have been
+// inserted, how large the caches have grown, and how far the tables have had
+// to probe.
+struct Statistics {
+    std::size_t assembly_hits = 0;
+    std::size_t assembly_misses = 0;
+    std::size_t coassembly_hits = 0;
+    std::size_t coassembly_misses = 0;
+    std::size_t inserts = 0;
+    std::size_t peak_size = 0;
+    std::size_t bytes = 0;
+    ProbeHistogram probe_lengths;
+};
+
+inline auto operator<<(std::ostream &out, ProbeHistogram const& histogram) -> std::ostream& {
+    auto last = ProbeHistogram::bins;
+    while (last > 1 && histogram[last - 1] == 0) {
+        --last;
+    }
+    for (std::size_t i = 0; i < last; ++i) {
+        out << (i == 0 ? "" : " ") << i << (i + 1 == ProbeHistogram::bins ? "+" : "") << ":" << histogram[i];
+    }
+    return out;
+}
+
+inline auto operator<<(std::ostream &out, Statistics const& stats) -> std::ostream& {
+    auto const rate = [](std::size_t hits, std::size_t misses) {
+        return (hits + misses == 0) ? 0.0 : static_cast<double>(hits) / (hits + misses);
+    };
+    return out << "assembly hits:     " << stats.assembly_hits << " (" << rate(stats.assembly_hits, stats.assembly_misses) << ")\n"
+               << "assembly misses:   " << stats.assembly_misses << '\n'
+               << "coassembly hits:   " << stats.coassembly_hits << " (" << rate(stats.coassembly_hits, stats.coassembly_misses) << ")\n"
+               << "coassembly misses: " << stats.coassembly_misses << '\n'
+               << "inserts:           " << stats.inserts << '\n'
+               << "peak size:         " << stats.peak_size << '\n'
+               << "bytes resident:    " << stats.bytes << '\n'
+               << "probe lengths:     " << stats.probe_lengths;
+}
+
+}
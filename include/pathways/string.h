@@ -1,35 +1,116 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include <string>
-#include <vector>
+#include <string_view>
 #include "pathways.h"
+#include "search.h"
+#include "simd.h"
 
 namespace pathways {
+    // A `StringDisassembly` lazily splits a string into each of its
+    // `(head, tail)` pairs, from a one-character head to a one-character tail.
+    // The range itself allocates nothing; each pair is only copied out of the
+    // string when it's dereferenced. It views the string it splits, which must
+    // outlive it.
+    class StringDisassembly {
+        private:
+            std::string_view _str;
+
+        public:
+            class const_iterator {
+                private:
+                    std::string_view _str;
+                    std::size_t _split;
+
+                public:
+                    using iterator_category = std::input_iterator_tag;
+                    using value_type = Components<std::string>;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = void;
+                    using reference = value_type;
+
+                    const_iterator(std::string_view str, std::size_t split) noexcept: _str{str}, _split{split} {}
+
+                    auto operator++() noexcept -> const_iterator& {
+                        ++this->_split;
+                        return *this;
+                    }
+
+                    auto operator++(int) noexcept -> const_iterator {
+                        auto temp = *this;
+                        ++this->_split;
+                        return temp;
+                    }
+
+                    auto operator*() const -> value_type {
+                        return { std::string(this->_str.substr(0, this->_split)),
+                                 std::string(this->_str.substr(this->_split)) };
+                    }
+
+                    auto operator==(const_iterator const& other) const noexcept -> bool {
+                        return this->_split == other._split;
+                    }
+
+                    auto operator!=(const_iterator const& other) const noexcept -> bool {
+                        return !(*this == other);
+                    }
+            };
+
+            explicit StringDisassembly(std::string_view str): _str{str} {
+                if (str.empty()) {
+                    throw std::invalid_argument("string is empty");
+                }
+            }
+
+            auto begin() const noexcept -> const_iterator {
+                return const_iterator(this->_str, 1);
+            }
+
+            auto end() const noexcept -> const_iterator {
+                return const_iterator(this->_str, std::max(std::size(this->_str), std::size_t{1}));
+            }
+
+            auto size() const noexcept -> std::size_t {
+                return std::size(this->_str) - 1;
+            }
+
+            auto empty() const noexcept -> bool {
+                return std::size(this->_str) == 1;
+            }
+    };
+
+    template <>
+    struct default_hash<std::string> {
+        using type = StringHash;
+    };
+
     template <>
     struct disassembly_type<std::string> {
-        using value = std::vector<Components<std::string>>;
+        using value = StringDisassembly;
     };
 
     template <>
-    auto is_basic<std::string>(std::string const& str) -> bool {
+    inline auto is_basic<std::string>(std::string const& str) -> bool {
         return std::size(str) == 1;
     }
 
     template <>
-    auto is_below<std::string>(std::string const& x, std::string const& y) -> bool {
-        return y.find(x) != std::string::npos;
+    inline auto is_below<std::string>(std::string const& x, std::string const& y) -> bool {
+        return simd_contains(y, x);
+    }
+
+    template <>
+    inline auto relation<std::string>(std::string const& x, std::string const& y) -> Relation {
+        return string_relation(x, y);
     }
 
     template <>
-    auto disassemble<std::string>(std::string const& str) -> std::vector<Components<std::string>> {
-        if (str.empty()) {
-            throw std::invalid_argument("string is empty");
-        }
-        auto parts = std::vector<Components<std::string>>{};
-        for (size_t i = 1, len = std::size(str); i < len; ++i) {
-            parts.emplace_back(str.substr(0, i), str.substr(i));
-        }
-        return parts;
+    inline auto disassemble<std::string>(std::string const& str) -> StringDisassembly {
+        return StringDisassembly(str);
     }
 
     template class Context<std::string>;
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "hash.h"
+#include "pathways.h"
+#include "search.h"
+#include <stdexcept>
+#include <string_view>
+
+namespace pathways {
+
+// A `StringViewDisassembly` lazily splits a string into each of its
+// `(head, tail)` pairs, from a one-character head to a one-character tail.
+// The components are views of the original characters, so nothing is copied
+// or allocated, and the iterator rolls the polynomial hashes of both parts
+// along as it goes (see `PrefixHash`): each step appends one character to the
+// head's hash and removes it from the front of the tail's, in constant time.
+// The components are yielded as `Prehashed` pairs, so a `Context` hashing with
+// `PolynomialHash` never rehashes them.
+class StringViewDisassembly {
+    private:
+        std::string_view _str;
+
+    public:
+        using value_type = Prehashed<std::string_view, PolynomialHash>;
+
+        class const_iterator {
+            private:
+                std::string_view _str;
+                std::size_t _split;
+                std::uint64_t _head_hash = 0;
+                std::uint64_t _tail_hash = 0;
+                // The `_power` is `B^(n - 1)` for a tail of length `n`, and
+                // the `inverse_base` of `B` is used to step it down.
+                std::uint64_t _power = 0;
+
+                static constexpr std::uint64_t inverse_base = PrefixHash::inverse(PrefixHash::default_base);
+
+            public:
+                const_iterator(std::string_view str, std::size_t split): _str{str}, _split{split} {
+                    if (split == 1) {
+                        this->_head_hash = PrefixHash::append(0, str[0]);
+                        this->_tail_hash = PrefixHash::hash(str.substr(1));
+                        this->_power = PrefixHash::pow(PrefixHash::default_base, std::size(str) - 2);
+                    }
+                }
+
+                auto operator++() -> const_iterator& {
+                    auto const c = this->_str[this->_split];
+                    this->_head_hash = PrefixHash::append(this->_head_hash, c);
+                    this->_tail_hash = PrefixHash::remove_front(this->_tail_hash, c, this->_power);
+                    this->_power = PrefixHash::times(this->_power, inverse_base);
+                    ++this->_split;
+                    return *this;
+                }
+
+                auto operator++(int) -> const_iterator {
+                    auto temp = *this;
+                    operator++();
+                    return temp;
+                }
+
+                auto operator*() const -> value_type {
+                    return { this->_str.substr(0, this->_split), this->_head_hash,
+                             this->_str.substr(this->_split), this->_tail_hash };
+                }
+
+                auto operator==(const_iterator const& other) const -> bool {
+                    return this->_split == other._split;
+                }
+
+                auto operator!=(const_iterator const& other) const -> bool {
+                    return !(*this == other);
+                }
+        };
+
+        explicit StringViewDisassembly(std::string_view str): _str{str} {
+            if (str.empty()) {
+                throw std::invalid_argument("string is empty");
+            }
+        }
+
+        auto begin() const -> const_iterator {
+            return const_iterator(this->_str, std::size(this->_str) > 1 ? 1 : 0);
+        }
+
+        auto end() const -> const_iterator {
+            return const_iterator(this->_str, std::size(this->_str) > 1 ? std::size(this->_str) : 0);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return std::size(this->_str) - 1;
+        }
+};
+
+// A `std::string_view` can be used as an object in its own right. The views
+// never own their characters, so the string a context is asked about must
+// outlive the query — but then disassembly copies nothing at all:
+//
+// ```cpp
+// auto const str = std::string{"0110101110"};
+// Context<std::string_view> ctx;
+// ctx.assembly_index(str);
+// ```
+//
+// Views are hashed with `PolynomialHash` by default, which is what lets the
+// context use the hashes rolled along by `StringViewDisassembly`.
+template <>
+struct default_hash<std::string_view> {
+    using type = PolynomialHash;
+};
+
+template <>
+struct disassembly_type<std::string_view> {
+    using value = StringViewDisassembly;
+};
+
+template <>
+inline auto is_basic<std::string_view>(std::string_view const& str) -> bool {
+    return std::size(str) == 1;
+}
+
+template <>
+inline auto is_below<std::string_view>(std::string_view const& x, std::string_view const& y) -> bool {
+    return simd_contains(y, x);
+}
+
+template <>
+inline auto relation<std::string_view>(std::string_view const& x, std::string_view const& y) -> Relation {
+    return string_relation(x, y);
+}
+
+template <>
+inline auto disassemble<std::string_view>(std::string_view const& str) -> StringViewDisassembly {
+    return StringViewDisassembly(str);
+}
+
+}
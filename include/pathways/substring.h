@@ -0,0 +1,209 @@
+#pragma once
+
+#include "hash.h"
+#include "pathways.h"
+#include "search.h"
+#include "suffix.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace pathways {
+
+class SubstringDisassembly;
+
+// A `Substring` is a view of a window of some root string, which it shares
+// with every other `Substring` cut from the same root. Alongside the string
+// itself, the root holds the prefix hashes of the string (see `PrefixHash`),
+// so hashing any substring is constant-time rather than linear in its length.
+//
+// This matters because a `Context` hashes every object and pair of objects it
+// looks up, and for `std::string` each of those hashes rereads the characters.
+// Disassembling a `Substring` also avoids copying: its disassembly is a lazy
+// range which cuts each component as a new window onto the same root when it
+// is reached, so nothing is allocated and no characters are copied. The root
+// also holds a second set of prefix hashes with a different base, so 128-bit
+// `Fingerprint`s are constant-time too.
+//
+// Substrings of the same root are compared through a `SuffixIndex` of the
+// root rather than by searching their characters. The index is built the first
+// time it's needed, so its cost is paid once for each root, i.e. once for each
+// top-level query, and only by queries which compare substrings at all.
+//
+// ```cpp
+// Context<Substring> ctx;
+// ctx.assembly_index(Substring{"0110101110"});
+// ```
+class Substring {
+    private:
+        struct Root {
+            std::string str;
+            PrefixHash hash;
+            PrefixHash alternate;
+
+            // The suffix index of the string, which is built on first use.
+            mutable std::once_flag indexed;
+            mutable SuffixIndex suffixes;
+
+            explicit Root(std::string str):
+                str{std::move(str)},
+                hash{this->str},
+                alternate{this->str, PrefixHash::alternate_base} {}
+
+            auto index() const -> SuffixIndex const& {
+                std::call_once(this->indexed, [this]() { this->suffixes = SuffixIndex{this->str}; });
+                return this->suffixes;
+            }
+        };
+
+        std::shared_ptr<Root const> _root;
+        std::size_t _offset;
+        std::size_t _length;
+
+        friend class SubstringDisassembly;
+
+        Substring(std::shared_ptr<Root const> root, std::size_t offset, std::size_t length):
+            _root{std::move(root)}, _offset{offset}, _length{length} {}
+
+    public:
+        using disassembly_type = SubstringDisassembly;
+
+        Substring() = delete;
+
+        Substring(std::string str): Substring{std::make_shared<Root const>(std::move(str)), 0, 0} {
+            if (this->_root->str.empty()) {
+                throw std::invalid_argument("string is empty");
+            }
+            this->_length = std::size(this->_root->str);
+        }
+
+        Substring(char const *str): Substring{std::string(str)} {}
+
+        // Get the characters of the substring.
+        auto view() const noexcept -> std::string_view {
+            return std::string_view(this->_root->str).substr(this->_offset, this->_length);
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_length;
+        }
+
+        // Get the hash of the substring in constant time. Equal substrings
+        // have equal hashes, whether or not they share a root.
+        auto hash() const noexcept -> std::size_t {
+            return this->_root->hash(this->_offset, this->_length);
+        }
+
+        // Get the 128-bit fingerprint of the substring in constant time, for
+        // use with `FingerprintHash<Substring>`.
+        auto fingerprint() const noexcept -> Fingerprint {
+            return { this->hash(), this->_root->alternate(this->_offset, this->_length) };
+        }
+
+        auto is_basic() const -> bool {
+            return this->_length == 1;
+        }
+
+        auto is_below(Substring const& other) const -> bool {
+            if (this->_root == other._root) {
+                return this->_root->index().occurs(this->_offset, this->_length, other._offset, other._length);
+            }
+            return simd_contains(other.view(), this->view());
+        }
+
+        auto disassemble() const noexcept -> disassembly_type;
+
+        friend auto operator==(Substring const& x, Substring const& y) noexcept -> bool {
+            return x.view() == y.view();
+        }
+
+        friend auto operator!=(Substring const& x, Substring const& y) noexcept -> bool {
+            return !(x == y);
+        }
+};
+
+// A `SubstringDisassembly` lazily yields the `(head, tail)` windows of a
+// substring, from a one-character head to a one-character tail. Its iterators
+// refer to the copy of the substring the range holds, so the range must
+// outlive them, as with any container.
+class SubstringDisassembly {
+    private:
+        Substring _whole;
+
+    public:
+        class const_iterator {
+            private:
+                Substring const *_whole;
+                std::size_t _split;
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = Components<Substring>;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = value_type;
+
+                const_iterator(Substring const *whole, std::size_t split) noexcept: _whole{whole}, _split{split} {}
+
+                auto operator++() noexcept -> const_iterator& {
+                    ++this->_split;
+                    return *this;
+                }
+
+                auto operator*() const -> value_type {
+                    auto const& whole = *this->_whole;
+                    return { Substring{whole._root, whole._offset, this->_split},
+                             Substring{whole._root, whole._offset + this->_split, whole._length - this->_split} };
+                }
+
+                auto operator==(const_iterator const& other) const noexcept -> bool {
+                    return this->_split == other._split;
+                }
+
+                auto operator!=(const_iterator const& other) const noexcept -> bool {
+                    return !(*this == other);
+                }
+        };
+
+        explicit SubstringDisassembly(Substring whole) noexcept: _whole{std::move(whole)} {}
+
+        auto begin() const noexcept -> const_iterator {
+            return const_iterator(&this->_whole, 1);
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return const_iterator(&this->_whole, std::max(this->_whole._length, std::size_t{1}));
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return this->_whole._length - 1;
+        }
+};
+
+inline auto Substring::disassemble() const noexcept -> disassembly_type {
+    return SubstringDisassembly(*this);
+}
+
+template <>
+inline auto relation<Substring>(Substring const& x, Substring const& y) -> Relation {
+    if (std::size(x) <= std::size(y)) {
+        return x.is_below(y) ? Relation::below : Relation::incomparable;
+    }
+    return y.is_below(x) ? Relation::above : Relation::incomparable;
+}
+
+}
+
+namespace std {
+    template <> struct hash<pathways::Substring> {
+        auto operator()(pathways::Substring const& arg) const noexcept -> std::size_t {
+            return arg.hash();
+        }
+    };
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pathways {
+
+// A `SuffixIndex` answers whether one substring of a string occurs within
+// another without reading any characters. It holds the suffix array of the
+// string, the longest common prefixes (LCP) of neighbouring suffixes in it, a
+// sparse table over the LCPs and a merge-sort tree over the suffix array.
+//
+// The suffixes which begin with the substring at `offset` are those around
+// `rank(offset)` in the suffix array whose common prefix with it is at least as
+// long as the substring. The sparse table finds the ends of that run in `O(log
+// n)` steps, and the merge-sort tree then tells whether any of them begin
+// within the window being searched in `O(log² n)`. Substrings which are already
+// windows of the one being searched, or are the same length as it, take
+// constant time.
+//
+// Building the index takes `O(n log² n)` time and `O(n log n)` space for a
+// string of length `n`.
+class SuffixIndex {
+    private:
+        // The start of each suffix, in lexicographic order.
+        std::vector<std::size_t> _suffixes;
+
+        // The `_rank` of each suffix in `_suffixes`.
+        std::vector<std::size_t> _rank;
+
+        // The `_lcp[k][r]` is the shortest common prefix of the `2^k` pairs of
+        // neighbouring suffixes ending at ranks `r` through `r + 2^k - 1`, and
+        // `_lcp[0][r]` is that of the suffixes at ranks `r - 1` and `r`.
+        std::vector<std::vector<std::size_t>> _lcp;
+
+        // Each `_sorted[k]` holds the suffix array sorted within consecutive
+        // blocks of `2^k` ranks.
+        std::vector<std::vector<std::size_t>> _sorted;
+
+        // Runs of suffixes shorter than this are scanned rather than searched
+        // in the merge-sort tree.
+        static constexpr std::size_t scan = 16;
+
+        // Extend the run of suffixes at `rank` which share a prefix of `length`
+        // as far as it goes in both directions.
+        auto run(std::size_t rank, std::size_t length) const noexcept -> std::pair<std::size_t, std::size_t> {
+            auto const n = std::size(this->_suffixes);
+            auto lo = rank, hi = rank;
+            for (auto k = std::size(this->_lcp); k-- > 0;) {
+                auto const span = std::size_t{1} << k;
+                if (lo >= span && this->_lcp[k][lo - span + 1] >= length) {
+                    lo -= span;
+                }
+                if (hi + span < n && this->_lcp[k][hi + 1] >= length) {
+                    hi += span;
+                }
+            }
+            return { lo, hi };
+        }
+
+        // Determine whether any suffix ranked in `[lo, hi)` begins in `[first,
+        // last]`.
+        auto any_between(std::size_t lo, std::size_t hi, std::size_t first, std::size_t last) const noexcept -> bool {
+            if (hi - lo < scan) {
+                return std::any_of(std::begin(this->_suffixes) + lo, std::begin(this->_suffixes) + hi,
+                                   [first, last](auto start) { return first <= start && start <= last; });
+            }
+            auto const n = std::size(this->_suffixes);
+            auto const within = [&](std::size_t k, std::size_t block) {
+                auto const& sorted = this->_sorted[k];
+                auto const begin = std::begin(sorted) + (block << k);
+                auto const end = std::begin(sorted) + std::min((block + 1) << k, n);
+                auto const start = std::lower_bound(begin, end, first);
+                return start != end && *start <= last;
+            };
+            for (std::size_t k = 0; lo < hi; ++k, lo >>= 1, hi >>= 1) {
+                if ((lo & 1) && within(k, lo++)) {
+                    return true;
+                }
+                if ((hi & 1) && within(k, --hi)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    public:
+        SuffixIndex() = default;
+
+        explicit SuffixIndex(std::string_view str) {
+            auto const n = std::size(str);
+            this->_suffixes.resize(n);
+            this->_rank.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                this->_suffixes[i] = i;
+                this->_rank[i] = static_cast<unsigned char>(str[i]);
+            }
+
+            // Sort the suffixes by their first `2^k` characters, doubling `k`
+            // until every suffix has a distinct rank.
+            auto next = std::vector<std::size_t>(n);
+            for (std::size_t span = 1; n > 1; span <<= 1) {
+                auto const key = [this, span, n](std::size_t i) {
+                    return std::make_pair(this->_rank[i], i + span < n ? this->_rank[i + span] + 1 : 0);
+                };
+                std::sort(std::begin(this->_suffixes), std::end(this->_suffixes),
+                          [&key](auto i, auto j) { return key(i) < key(j); });
+                next[this->_suffixes[0]] = 0;
+                for (std::size_t r = 1; r < n; ++r) {
+                    auto const distinct = key(this->_suffixes[r - 1]) < key(this->_suffixes[r]);
+                    next[this->_suffixes[r]] = next[this->_suffixes[r - 1]] + distinct;
+                }
+                this->_rank.swap(next);
+                if (this->_rank[this->_suffixes[n - 1]] == n - 1) {
+                    break;
+                }
+            }
+            if (n == 1) {
+                this->_rank[0] = 0;
+            }
+
+            // Kasai's algorithm: the common prefix of each suffix with the one
+            // ranked before it is at most one shorter than that of the suffix
+            // which starts a character earlier.
+            auto lcp = std::vector<std::size_t>(n, 0);
+            for (std::size_t i = 0, h = 0; i < n; ++i) {
+                if (this->_rank[i] == 0) {
+                    h = 0;
+                    continue;
+                }
+                auto const j = this->_suffixes[this->_rank[i] - 1];
+                while (i + h < n && j + h < n && str[i + h] == str[j + h]) {
+                    ++h;
+                }
+                lcp[this->_rank[i]] = h;
+                if (h > 0) {
+                    --h;
+                }
+            }
+            this->_lcp.push_back(std::move(lcp));
+            for (std::size_t span = 1; 2 * span <= n; span <<= 1) {
+                auto const& below = this->_lcp.back();
+                auto above = std::vector<std::size_t>(n - 2 * span + 1);
+                for (std::size_t r = 0; r < std::size(above); ++r) {
+                    above[r] = std::min(below[r], below[r + span]);
+                }
+                this->_lcp.push_back(std::move(above));
+            }
+
+            this->_sorted.push_back(this->_suffixes);
+            for (std::size_t span = 1; span < n; span <<= 1) {
+                auto sorted = this->_sorted.back();
+                for (std::size_t lo = 0; lo + span < n; lo += 2 * span) {
+                    auto const mid = std::begin(sorted) + lo + span;
+                    auto const hi = std::begin(sorted) + std::min(lo + 2 * span, n);
+                    std::inplace_merge(std::begin(sorted) + lo, mid, hi);
+                }
+                this->_sorted.push_back(std::move(sorted));
+            }
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return std::size(this->_suffixes);
+        }
+
+        // Get the start of the suffix with a given lexicographic rank.
+        auto suffix(std::size_t rank) const noexcept -> std::size_t {
+            return this->_suffixes[rank];
+        }
+
+        // Get the lexicographic rank of the suffix starting at `offset`.
+        auto rank(std::size_t offset) const noexcept -> std::size_t {
+            return this->_rank[offset];
+        }
+
+        // Get the length of the longest common prefix of the suffixes starting
+        // at `i` and `j`.
+        auto lcp(std::size_t i, std::size_t j) const noexcept -> std::size_t {
+            if (i == j) {
+                return std::size(this->_suffixes) - i;
+            }
+            auto lo = this->_rank[i], hi = this->_rank[j];
+            if (lo > hi) {
+                std::swap(lo, hi);
+            }
+            auto k = std::size_t{0};
+            while ((std::size_t{2} << k) <= hi - lo) {
+                ++k;
+            }
+            return std::min(this->_lcp[k][lo + 1], this->_lcp[k][hi - (std::size_t{1} << k) + 1]);
+        }
+
+        // Determine whether the `length` characters at `offset` occur within
+        // the `within` characters at `start`. Both must lie within the string.
+        auto occurs(std::size_t offset, std::size_t length, std::size_t start, std::size_t within) const noexcept -> bool {
+            if (length > within) {
+                return false;
+            } else if (length == 0 || (start <= offset && offset + length <= start + within)) {
+                return true;
+            } else if (length == within) {
+                return this->lcp(offset, start) >= length;
+            }
+            auto const [lo, hi] = this->run(this->_rank[offset], length);
+            return this->any_between(lo, hi + 1, start, start + within - length);
+        }
+};
+
+}
@@ -1,6 +1,7 @@
 #include "catch2/catch.hpp"
 #include <algorithm>
 #include <numeric>
+#include <vector>
 #include <pathways/addition.h>
 
 #include <iostream>
@@ -47,9 +48,8 @@ TEST_CASE("ints satisfy the pathways interface", "[addition]") {
     }
 
     SECTION("can dissassemble an int") {
-        using container = typename disassembly_type<int>::value;
-        container const expected = { {1, 6}, {2, 5}, {3, 4} };
-        container const got = disassemble(7);
+        auto const expected = std::vector<Components<int>>{ {1, 6}, {2, 5}, {3, 4} };
+        auto const got = disassemble(7);
 
         REQUIRE(std::size(got) == std::size(expected));
         REQUIRE(std::equal(std::begin(got), std::end(got), std::begin(expected)));
@@ -77,3 +77,114 @@ TEST_CASE("can estimate the assembly index for an int", "[addition]") {
         REQUIRE(std::equal(std::begin(got), std::end(got), std::begin(expected)));
     }
 }
+
+TEST_CASE("the assembly index does not depend on the cache policy", "[addition]") {
+    using namespace pathways;
+
+    Context<int, disassembly_type<int>::value, MapCache> map_ctx;
+    Context<int, disassembly_type<int>::value, FlatCache> flat_ctx;
+    Context<int, disassembly_type<int>::value, CompactCache> compact_ctx;
+    for (int n = 1; n <= 64; ++n) {
+        REQUIRE(map_ctx.assembly_index(n) == flat_ctx.assembly_index(n));
+        REQUIRE(map_ctx.assembly_index(n) == compact_ctx.assembly_index(n));
+    }
+    REQUIRE(map_ctx.cache_size() == flat_ctx.cache_size());
+    REQUIRE(map_ctx.cache_size() == compact_ctx.cache_size());
+}
+
+TEST_CASE("a bounded context agrees with an unbounded context", "[addition]") {
+    using namespace pathways;
+    using Bounded = BoundedContext<int>;
+
+    Context<int> ctx;
+    Bounded bounded{Bounded::assembly_cache_type(32), Bounded::coassembly_cache_type(32)};
+    for (int n = 1; n <= 64; ++n) {
+        REQUIRE(bounded.assembly_index(n) == ctx.assembly_index(n));
+    }
+    REQUIRE(bounded.assembly_cache_size() <= 32);
+    REQUIRE(bounded.coassembly_cache_size() <= 32);
+    REQUIRE(bounded.cache_evictions() > 0);
+    REQUIRE(ctx.cache_evictions() == 0);
+}
+
+TEST_CASE("coassembly indices are cached symmetrically", "[addition]") {
+    using namespace pathways;
+
+    Context<int> ctx;
+    auto const cc = ctx.coassembly_index(5, 7);
+    auto const size = ctx.coassembly_cache_size();
+    REQUIRE(ctx.coassembly_index(7, 5) == cc);
+    REQUIRE(ctx.coassembly_cache_size() == size);
+}
+
+TEST_CASE("a context can be pruned", "[addition]") {
+    using namespace pathways;
+
+    SECTION("keeping only assembly indices") {
+        Context<int> ctx;
+        ctx.assembly_index(64);
+        auto const size = ctx.assembly_cache_size();
+        REQUIRE(ctx.coassembly_cache_size() > 0);
+        REQUIRE(ctx.prune(Retention::assembly_only()) > 0);
+        REQUIRE(ctx.assembly_cache_size() == size);
+        REQUIRE(ctx.coassembly_cache_size() == 0);
+    }
+
+    SECTION("keeping only small objects") {
+        Context<int> ctx;
+        ctx.assembly_index(64);
+        ctx.prune(Retention::index_at_most(3));
+        REQUIRE(ctx.cache_size() > 0);
+        for (int n = 2; n <= 64; ++n) {
+            auto const size = ctx.assembly_cache_size();
+            auto const c = ctx.assembly_index(n);
+            REQUIRE((c <= 3) == (ctx.assembly_cache_size() == size));
+        }
+    }
+
+    SECTION("between queries") {
+        Context<int> ctx;
+        Context<int> retaining;
+        retaining.retention(Retention::assembly_only());
+        for (int n = 1; n <= 64; ++n) {
+            REQUIRE(retaining.assembly_index(n) == ctx.assembly_index(n));
+            REQUIRE(retaining.coassembly_cache_size() == 0);
+        }
+        REQUIRE(retaining.assembly_cache_size() == ctx.assembly_cache_size());
+    }
+}
+
+TEST_CASE("a context collects cache statistics", "[addition]") {
+    using namespace pathways;
+
+    Context<int> ctx;
+    ctx.assembly_index(32);
+    auto const first = ctx.statistics();
+    REQUIRE(first.bytes > 0);
+
+    if constexpr (collect_statistics) {
+        REQUIRE(first.inserts == ctx.cache_size());
+        REQUIRE(first.peak_size == ctx.cache_size());
+        REQUIRE(first.assembly_misses == ctx.assembly_cache_size());
+        REQUIRE(first.coassembly_misses == ctx.coassembly_cache_size());
+        REQUIRE(first.probe_lengths.total() > 0);
+
+        ctx.assembly_index(32);
+        auto const second = ctx.statistics();
+        REQUIRE(second.assembly_hits == first.assembly_hits + 1);
+        REQUIRE(second.inserts == first.inserts);
+
+        ctx.prune(Retention::assembly_only());
+        REQUIRE(ctx.statistics().peak_size == first.peak_size);
+    } else {
+        // Without `PATHWAYS_STATISTICS`, only the memory footprint is reported.
+        REQUIRE(first.inserts == 0);
+        REQUIRE(first.peak_size == 0);
+        REQUIRE(first.assembly_misses == 0);
+        REQUIRE(first.coassembly_misses == 0);
+        REQUIRE(first.probe_lengths.total() == 0);
+
+        ctx.assembly_index(32);
+        REQUIRE(ctx.statistics().assembly_hits == 0);
+    }
+}
@@ -0,0 +1,77 @@
+#include "catch2/catch.hpp"
+#include <pathways/binary.h>
+#include <pathways/string.h>
+#include <set>
+
+TEST_CASE("short binary strings have dense codes", "[binary]") {
+    using namespace pathways;
+
+    REQUIRE(binary_code("0") == 0b10);
+    REQUIRE(binary_code("1") == 0b11);
+    REQUIRE(binary_code("01") == 0b101);
+    REQUIRE(binary_code("001") == 0b1001);
+    REQUIRE(binary_code("012") == binary_code_limit);
+    REQUIRE(binary_code(std::string(short_binary_length, '1')) == binary_code_limit - 1);
+    REQUIRE(binary_code(std::string(short_binary_length + 1, '1')) == binary_code_limit);
+
+    auto const hash = BinaryHash{};
+    REQUIRE(hash("0110") == binary_code("0110"));
+    REQUIRE(hash("abc") >= binary_code_limit);
+    REQUIRE(hash(std::string(32, '0')) >= binary_code_limit);
+}
+
+TEST_CASE("BinaryCache stores short keys directly", "[binary]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("single keys") {
+        BinaryCache<std::size_t, uint32_t> cache;
+        REQUIRE(!cache.find(binary_code("0110")));
+        cache.insert(binary_code("0110"), 3);
+        cache.insert(BinaryHash{}("abc"), 300);
+        REQUIRE(cache.find(binary_code("0110")) == 3u);
+        REQUIRE(cache.find(BinaryHash{}("abc")) == 300u);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.erase_if([](auto const&, uint32_t value) { return value < 10; }) == 1);
+        REQUIRE(!cache.find(binary_code("0110")));
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("pairs of keys") {
+        BinaryCache<Key, uint32_t> cache;
+        auto const short_pairs = std::vector<Key>{
+            { binary_code("0"), binary_code("01") },
+            { binary_code("00"), binary_code("1") },
+            { binary_code("01"), binary_code("0") },
+            { binary_code(std::string(8, '1')), binary_code(std::string(8, '0')) },
+        };
+        for (std::size_t i = 0; i < std::size(short_pairs); ++i) {
+            cache.insert(short_pairs[i], static_cast<uint32_t>(i));
+        }
+        auto const long_pair = Key{ binary_code(std::string(9, '1')), binary_code(std::string(8, '0')) };
+        cache.insert(long_pair, 100);
+        REQUIRE(cache.size() == std::size(short_pairs) + 1);
+        for (std::size_t i = 0; i < std::size(short_pairs); ++i) {
+            REQUIRE(cache.find(short_pairs[i]) == static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.find(long_pair) == 100u);
+
+        auto erased = std::set<Key>{};
+        cache.erase_if([&erased](Key const& key, uint32_t) { erased.insert(key); return true; });
+        REQUIRE(cache.size() == 0);
+        REQUIRE(std::size(erased) == std::size(short_pairs) + 1);
+        for (auto const& key: short_pairs) {
+            REQUIRE(erased.count(key) == 1);
+        }
+    }
+}
+
+TEST_CASE("binary contexts agree with string contexts", "[binary]") {
+    using namespace pathways;
+
+    Context<std::string> strings;
+    Context<std::string, disassembly_type<std::string>::value, BinaryCache, BinaryHash> binary;
+    for (auto const& str: { "011101", "0110101110010101110", "01101011100101011100101101110010111010", "abracadabra" }) {
+        REQUIRE(binary.assembly_index(str) == strings.assembly_index(str));
+    }
+}
@@ -0,0 +1,341 @@
+#include "catch2/catch.hpp"
+#include <pathways/cache.h>
+
+TEST_CASE("FlatCache stores and retrieves values", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("an empty cache finds nothing") {
+        FlatCache<Key, uint32_t> cache;
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.capacity() == 0);
+        REQUIRE(!cache.find({1, 2}));
+    }
+
+    SECTION("can insert and find values") {
+        FlatCache<Key, uint32_t> cache;
+        REQUIRE(cache.insert({1, 2}, 3) == 3);
+        REQUIRE(cache.insert({2, 1}, 4) == 4);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.find({1, 2}) == 3u);
+        REQUIRE(cache.find({2, 1}) == 4u);
+        REQUIRE(!cache.find({1, 1}));
+    }
+
+    SECTION("inserting an existing key overwrites its value") {
+        FlatCache<Key, uint32_t> cache;
+        cache.insert({1, 2}, 3);
+        cache.insert({1, 2}, 5);
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.find({1, 2}) == 5u);
+    }
+
+    SECTION("grows to hold many entries") {
+        FlatCache<Key, uint32_t> cache;
+        for (std::size_t i = 0; i < 10000; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.size() == 10000);
+        REQUIRE(cache.load_factor() <= cache.max_load_factor());
+        for (std::size_t i = 0; i < 10000; ++i) {
+            REQUIRE(cache.find({i, i}) == static_cast<uint32_t>(i));
+        }
+    }
+
+    SECTION("clear removes entries but keeps capacity") {
+        FlatCache<Key, uint32_t> cache;
+        cache.insert({1, 2}, 3);
+        auto const capacity = cache.capacity();
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.capacity() == capacity);
+        REQUIRE(!cache.find({1, 2}));
+    }
+}
+
+TEST_CASE("FlatCache can be pre-sized", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("reserve allocates a power of two number of slots") {
+        FlatCache<Key, uint32_t> cache;
+        cache.reserve(1000);
+        auto const capacity = cache.capacity();
+        REQUIRE(capacity >= 2000);
+        REQUIRE((capacity & (capacity - 1)) == 0);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            cache.insert({i, i + 1}, 0);
+        }
+        REQUIRE(cache.capacity() == capacity);
+    }
+
+    SECTION("max load factor must be in (0, 1)") {
+        FlatCache<Key, uint32_t> cache;
+        REQUIRE_THROWS_AS(cache.max_load_factor(0.0f), std::invalid_argument);
+        REQUIRE_THROWS_AS(cache.max_load_factor(1.0f), std::invalid_argument);
+        cache.max_load_factor(0.875f);
+        cache.reserve(875);
+        REQUIRE(cache.capacity() == 1024);
+    }
+}
+
+TEST_CASE("MapCache satisfies the cache policy interface", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    MapCache<Key, uint32_t> cache;
+    cache.reserve(10);
+    REQUIRE(!cache.find({1, 2}));
+    REQUIRE(cache.insert({1, 2}, 3) == 3);
+    REQUIRE(cache.insert({1, 2}, 4) == 4);
+    REQUIRE(cache.find({1, 2}) == 4u);
+    REQUIRE(cache.size() == 1);
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("BoundedCache never exceeds its bounds", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("must hold at least one entry") {
+        REQUIRE_THROWS_AS((BoundedCache<Key, uint32_t>(0)), std::invalid_argument);
+    }
+
+    SECTION("evicts entries once full") {
+        BoundedCache<Key, uint32_t> cache(100);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            REQUIRE(cache.insert({i, i + 1}, static_cast<uint32_t>(i)) == i);
+            REQUIRE(cache.find({i, i + 1}) == static_cast<uint32_t>(i));
+            REQUIRE(cache.size() <= 100);
+        }
+        REQUIRE(cache.size() == 100);
+        REQUIRE(cache.evictions() == 900);
+
+        auto found = std::size_t{0};
+        for (std::size_t i = 0; i < 1000; ++i) {
+            auto const value = cache.find({i, i + 1});
+            if (value) {
+                REQUIRE(value == static_cast<uint32_t>(i));
+                ++found;
+            }
+        }
+        REQUIRE(found == 100);
+    }
+
+    SECTION("gives every entry the same reference count") {
+        BoundedCache<Key, uint32_t> cache(8);
+        REQUIRE(cache.references() == 1);
+        cache.insert({0, 0}, 1);
+        for (std::size_t i = 1; i <= 12; ++i) {
+            cache.insert({i, i + 1}, 2);
+        }
+        REQUIRE(cache.evictions() == 5);
+        REQUIRE(!cache.find({0, 0}));
+    }
+
+    SECTION("can give every entry a larger reference count") {
+        BoundedCache<Key, uint32_t> patient(8, 3);
+        REQUIRE(patient.references() == 3);
+        for (std::size_t i = 0; i < 8; ++i) {
+            patient.insert({i, i + 1}, 2);
+        }
+        patient.insert({8, 9}, 2);
+        REQUIRE(patient.evictions() == 1);
+        REQUIRE(patient.size() == 8);
+        REQUIRE(patient.find({8, 9}) == 2u);
+    }
+
+    SECTION("can be bounded by memory") {
+        auto const cache = BoundedCache<Key, uint32_t>::with_memory(1 << 20);
+        REQUIRE(cache.max_entries() > 0);
+        REQUIRE(cache.max_entries() * 2 * 24 <= (1 << 20));
+    }
+}
+
+TEST_CASE("CompactCache stores wide values out of line", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("narrow values are stored inline") {
+        CompactCache<Key, uint32_t> cache;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            cache.insert({i, i + 1}, static_cast<uint32_t>(i % 254));
+        }
+        REQUIRE(cache.size() == 1000);
+        REQUIRE(cache.overflowed() == 0);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            REQUIRE(cache.find({i, i + 1}) == static_cast<uint32_t>(i % 254));
+        }
+        REQUIRE(!cache.find({1000, 1001}));
+    }
+
+    SECTION("wide values overflow") {
+        CompactCache<Key, uint32_t> cache;
+        cache.insert({1, 2}, 253);
+        cache.insert({2, 3}, 254);
+        cache.insert({3, 4}, 100000);
+        REQUIRE(cache.size() == 3);
+        REQUIRE(cache.overflowed() == 2);
+        REQUIRE(cache.find({1, 2}) == 253u);
+        REQUIRE(cache.find({2, 3}) == 254u);
+        REQUIRE(cache.find({3, 4}) == 100000u);
+    }
+
+    SECTION("values can change width") {
+        CompactCache<Key, uint32_t, uint16_t> cache;
+        cache.insert({1, 2}, 3);
+        cache.insert({1, 2}, 70000);
+        REQUIRE(cache.find({1, 2}) == 70000u);
+        cache.insert({1, 2}, 5);
+        REQUIRE(cache.find({1, 2}) == 5u);
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("clear removes overflowed values") {
+        CompactCache<Key, uint32_t> cache;
+        cache.insert({1, 2}, 1000);
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.overflowed() == 0);
+        REQUIRE(!cache.find({1, 2}));
+    }
+}
+
+TEST_CASE("cache policies can erase entries", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+    auto const odd = [](Key const&, uint32_t value) { return value & 1; };
+
+    SECTION("FlatCache") {
+        FlatCache<Key, uint32_t> cache;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.erase_if(odd) == 500);
+        REQUIRE(cache.size() == 500);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            REQUIRE(bool(cache.find({i, i})) == !(i & 1));
+        }
+    }
+
+    SECTION("MapCache") {
+        MapCache<Key, uint32_t> cache;
+        for (std::size_t i = 0; i < 10; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.erase_if(odd) == 5);
+        REQUIRE(cache.size() == 5);
+        REQUIRE(!cache.find({1, 1}));
+        REQUIRE(cache.find({2, 2}) == 2u);
+    }
+
+    SECTION("BoundedCache") {
+        BoundedCache<Key, uint32_t> cache(100);
+        for (std::size_t i = 0; i < 100; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.erase_if(odd) == 50);
+        for (std::size_t i = 0; i < 100; ++i) {
+            REQUIRE(bool(cache.find({i, i})) == !(i & 1));
+        }
+    }
+
+    SECTION("CompactCache") {
+        CompactCache<Key, uint32_t> cache;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.erase_if(odd) == 500);
+        REQUIRE(cache.size() == 500);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            auto const value = cache.find({i, i});
+            REQUIRE(bool(value) == !(i & 1));
+            if (value) {
+                REQUIRE(value == static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+TEST_CASE("FilteredCache rejects absent keys", "[cache]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("the filter has no false negatives") {
+        BloomFilter<Key> filter(64);
+        for (std::size_t i = 0; i < 1000; ++i) {
+            filter.insert({i, 2 * i});
+        }
+        for (std::size_t i = 0; i < 1000; ++i) {
+            REQUIRE(filter.contains({i, 2 * i}));
+        }
+    }
+
+    SECTION("behaves like a FlatCache") {
+        FilteredCache<Key, uint32_t> cache;
+        REQUIRE(!cache.find({0, 0}));
+        for (std::size_t i = 0; i < 10000; ++i) {
+            cache.insert({i, i}, static_cast<uint32_t>(i));
+        }
+        REQUIRE(cache.size() == 10000);
+        for (std::size_t i = 0; i < 10000; ++i) {
+            REQUIRE(cache.find({i, i}) == static_cast<uint32_t>(i));
+        }
+        auto const rejections = cache.rejections();
+        for (std::size_t i = 10000; i < 20000; ++i) {
+            REQUIRE(!cache.find({i, i}));
+        }
+        REQUIRE(cache.rejections() - rejections > 9000);
+
+        cache.erase_if([](Key const&, uint32_t value) { return value & 1; });
+        for (std::size_t i = 0; i < 10000; ++i) {
+            REQUIRE(bool(cache.find({i, i})) == !(i & 1));
+        }
+    }
+}
+
+TEST_CASE("DenseCache indexes values by ID", "[cache]") {
+    using namespace pathways;
+
+    SECTION("single IDs") {
+        DenseCache<std::size_t, uint32_t> cache;
+        REQUIRE(!cache.find(3));
+        REQUIRE(cache.insert(3, 7) == 7);
+        REQUIRE(cache.insert(0, 1) == 1);
+        REQUIRE(cache.insert(3, 8) == 8);
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.find(3) == 8u);
+        REQUIRE(!cache.find(2));
+        REQUIRE(!cache.find(1000));
+        REQUIRE(cache.erase_if([](std::size_t id, uint32_t) { return id == 0; }) == 1);
+        REQUIRE(!cache.find(0));
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("pairs of IDs") {
+        DenseCache<std::pair<std::size_t, std::size_t>, uint32_t> cache;
+        cache.insert({1, 2}, 3);
+        cache.insert({2, 1}, 4);
+        REQUIRE(cache.find({1, 2}) == 3u);
+        REQUIRE(cache.find({2, 1}) == 4u);
+        REQUIRE(cache.erase_if([](auto const& key, uint32_t) { return key.first == 2; }) == 1);
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.find({1, 2}) == 3u);
+    }
+
+    SECTION("pairs of IDs too wide to pack") {
+        DenseCache<std::pair<std::size_t, std::size_t>, uint32_t> cache;
+        auto const wide = std::size_t{1} << 32;
+        cache.insert({1, 1}, 5);
+        cache.insert({1, wide + 1}, 6);
+        cache.insert({wide, 1}, 7);
+        REQUIRE(cache.size() == 3);
+        REQUIRE(cache.find({1, 1}) == 5u);
+        REQUIRE(cache.find({1, wide + 1}) == 6u);
+        REQUIRE(cache.find({wide, 1}) == 7u);
+        REQUIRE(!cache.find({0, wide}));
+        REQUIRE(cache.erase_if([wide](auto const& key, uint32_t) { return key.first == wide; }) == 1);
+        REQUIRE(cache.size() == 2);
+    }
+}
@@ -0,0 +1,99 @@
+#include "catch2/catch.hpp"
+#include <pathways/frozen.h>
+#include <pathways/string.h>
+#include <map>
+
+TEST_CASE("FrozenCache finds exactly the frozen entries", "[frozen]") {
+    using namespace pathways;
+    using Key = std::pair<std::size_t, std::size_t>;
+
+    SECTION("an empty cache finds nothing") {
+        FrozenCache<std::size_t, uint32_t> cache;
+        REQUIRE(!cache.find(0));
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.levels() == 0);
+    }
+
+    SECTION("every frozen key is found, and no other") {
+        FlatCache<Key, uint32_t> warm;
+        for (std::size_t i = 0; i < 10000; ++i) {
+            warm.insert({ i, 3 * i }, static_cast<uint32_t>(i % 1000));
+        }
+        FrozenCache<Key, uint32_t> cache(warm);
+        REQUIRE(cache.size() == warm.size());
+        REQUIRE(cache.levels() > 1);
+        for (std::size_t i = 0; i < 10000; ++i) {
+            REQUIRE(cache.find({ i, 3 * i }) == static_cast<uint32_t>(i % 1000));
+            REQUIRE(!cache.find({ i, 3 * i + 1 }));
+        }
+        REQUIRE(cache.bytes() < warm.bytes());
+    }
+
+    SECTION("keys with identical slot hashes are spilled") {
+        struct Constant {
+            auto operator()(std::size_t) const noexcept -> std::size_t {
+                return 42;
+            }
+        };
+        auto const entries = std::vector<std::pair<std::size_t, uint32_t>>{ { 1, 1 }, { 2, 2 }, { 3, 3 } };
+        FrozenCache<std::size_t, uint32_t, std::uint8_t, Constant> cache(entries);
+        REQUIRE(cache.spilled() == 3);
+        for (auto const& [key, value]: entries) {
+            REQUIRE(cache.find(key) == value);
+        }
+        REQUIRE(!cache.find(4));
+    }
+
+    SECTION("can be inserted into after freezing") {
+        auto const entries = std::vector<std::pair<std::size_t, uint32_t>>{ { 1, 1 }, { 2, 300 }, { 3, 3 } };
+        FrozenCache<std::size_t, uint32_t> cache(entries);
+        REQUIRE(cache.find(2) == 300u);
+        cache.insert(1, 500);
+        cache.insert(2, 5);
+        cache.insert(4, 4);
+        REQUIRE(cache.find(1) == 500u);
+        REQUIRE(cache.find(2) == 5u);
+        REQUIRE(cache.find(4) == 4u);
+        REQUIRE(cache.size() == 4);
+
+        auto seen = std::map<std::size_t, uint32_t>{};
+        cache.for_each([&seen](std::size_t key, uint32_t value) { seen[key] += value; });
+        REQUIRE(seen == std::map<std::size_t, uint32_t>{ { 1, 500 }, { 2, 5 }, { 3, 3 }, { 4, 4 } });
+    }
+
+    SECTION("erasing refreezes the survivors") {
+        auto entries = std::vector<std::pair<std::size_t, uint32_t>>{};
+        for (std::size_t i = 0; i < 1000; ++i) {
+            entries.emplace_back(i, static_cast<uint32_t>(i));
+        }
+        FrozenCache<std::size_t, uint32_t> cache(entries);
+        REQUIRE(cache.erase_if([](std::size_t, uint32_t value) { return value >= 100; }) == 900);
+        REQUIRE(cache.size() == 100);
+        REQUIRE(cache.find(99) == 99u);
+        REQUIRE(!cache.find(100));
+        cache.clear();
+        REQUIRE(cache.size() == 0);
+        REQUIRE(!cache.find(0));
+    }
+}
+
+TEST_CASE("frozen contexts agree with the contexts they froze", "[frozen]") {
+    using namespace pathways;
+
+    auto const strs = { "011101", "0110101110010101110", "01101011100101011100101101110010111010", "abracadabra" };
+
+    Context<std::string> warm;
+    auto indices = std::vector<uint32_t>{};
+    for (auto const& str: strs) {
+        indices.push_back(warm.assembly_index(str));
+    }
+
+    auto frozen = freeze(warm);
+    REQUIRE(frozen.cache_size() == warm.cache_size());
+    auto i = std::size_t{0};
+    for (auto const& str: strs) {
+        REQUIRE(frozen.assembly_index(str) == indices[i++]);
+    }
+    REQUIRE(frozen.cache_size() == warm.cache_size());
+    REQUIRE(frozen.assembly_index("0101101101011") == warm.assembly_index("0101101101011"));
+}
@@ -0,0 +1,95 @@
+#include "catch2/catch.hpp"
+#include <pathways/addition.h>
+#include <pathways/hashcons.h>
+#include <pathways/string.h>
+#include <pathways/string_view.h>
+
+TEST_CASE("an object store keeps one copy of each object", "[hashcons]") {
+    using namespace pathways;
+
+    ObjectStore<std::string> store;
+    auto const x = store.intern("abc");
+    auto const y = store.intern(std::string("ab") + "c");
+    auto const z = store.intern("abd");
+    REQUIRE(x == y);
+    REQUIRE(x.id() == y.id());
+    REQUIRE(x != z);
+    REQUIRE(store.size() == 2);
+    REQUIRE(x.object() == "abc");
+    REQUIRE(std::hash<Consed<std::string>>{}(x) == x.id());
+}
+
+TEST_CASE("consed objects satisfy the pathways interface", "[hashcons]") {
+    using namespace pathways;
+
+    ObjectStore<std::string> store;
+    auto const str = store.intern("abcabc");
+    REQUIRE(!is_basic(str));
+    REQUIRE(is_basic(store.intern("a")));
+
+    auto const parts = disassemble(str);
+    REQUIRE(std::size(parts) == 5);
+    auto components = std::vector<Components<Consed<std::string>>>{};
+    for (auto const& part: parts) {
+        components.push_back(part);
+    }
+    auto const& [x, y] = components[2];
+    REQUIRE(x == y);
+    REQUIRE(x.object() == "abc");
+    REQUIRE(is_below(x, str));
+    REQUIRE(!is_below(str, x));
+
+    SECTION("and disassemble into the same handles every time") {
+        auto const size = store.size();
+        auto const again = disassemble(str);
+        auto i = std::size_t{0};
+        for (auto const& [a, b]: again) {
+            REQUIRE(a == components[i].first);
+            REQUIRE(b == components[i].second);
+            ++i;
+        }
+        REQUIRE(store.size() == size);
+    }
+}
+
+TEST_CASE("consed objects agree with the objects themselves", "[hashcons]") {
+    using namespace pathways;
+
+    SECTION("strings") {
+        Context<std::string> strings;
+        for (auto const& str: { "011101", "0110101110010101110", "abracadabra", "AAAAAAAAAAAA" }) {
+            ObjectStore<std::string> store;
+            Context<Consed<std::string>, disassembly_type<Consed<std::string>>::value, DenseCache> consed;
+            REQUIRE(consed.assembly_index(store.intern(str)) == strings.assembly_index(str));
+        }
+    }
+
+    SECTION("without caching") {
+        Context<std::string> strings;
+        ObjectStore<std::string> store;
+        Context<Consed<std::string>, disassembly_type<Consed<std::string>>::value, DenseCache> consed;
+        for (auto const& str: { "011101", "abracad", "AAAAAAAA" }) {
+            REQUIRE(consed.assembly_index(store.intern(str), false) == strings.assembly_index(str, false));
+        }
+    }
+
+    SECTION("string views, whose disassemblies are prehashed") {
+        Context<std::string_view> views;
+        ObjectStore<std::string_view> store;
+        Context<Consed<std::string_view>, disassembly_type<Consed<std::string_view>>::value, DenseCache> consed;
+        for (auto const str: { std::string_view{"011101"}, std::string_view{"abracadabra"}, std::string_view{"AAAAAAAAAAAA"} }) {
+            REQUIRE(consed.assembly_index(store.intern(str)) == views.assembly_index(str));
+        }
+        REQUIRE(store.intern("abra") == store.intern(std::string_view{"abracadabra"}.substr(7)));
+    }
+
+    SECTION("integers") {
+        Context<int> integers;
+        ObjectStore<int> store;
+        Context<Consed<int>, disassembly_type<Consed<int>>::value, DenseCache> consed;
+        for (int n = 1; n <= 64; ++n) {
+            REQUIRE(consed.assembly_index(store.intern(n)) == integers.assembly_index(n));
+        }
+        REQUIRE(store.size() == 64);
+    }
+}
@@ -0,0 +1,45 @@
+#include "catch2/catch.hpp"
+#include <pathways/intern.h>
+#include <pathways/substring.h>
+#include <set>
+
+TEST_CASE("a suffix automaton numbers distinct substrings densely", "[intern]") {
+    using namespace pathways;
+
+    for (auto const str: { "a", "aaaa", "abcabc", "0110101110010101110", "abracadabra" }) {
+        auto const view = std::string_view(str);
+        auto const automaton = SuffixAutomaton{view};
+        REQUIRE(automaton.states() <= 2 * std::size(view));
+
+        auto ids = std::map<std::string_view, std::size_t>{};
+        for (std::size_t i = 0; i < std::size(view); ++i) {
+            for (std::size_t n = 1; i + n <= std::size(view); ++n) {
+                auto const id = automaton.id(i, n);
+                auto const [iter, inserted] = ids.emplace(view.substr(i, n), id);
+                REQUIRE(iter->second == id);
+            }
+        }
+        REQUIRE(automaton.distinct() == std::size(ids));
+
+        auto distinct = std::set<std::size_t>{};
+        for (auto const& [substr, id]: ids) {
+            REQUIRE(id < automaton.distinct());
+            distinct.insert(id);
+        }
+        REQUIRE(std::size(distinct) == std::size(ids));
+    }
+}
+
+TEST_CASE("interned strings agree with substrings", "[intern]") {
+    using namespace pathways;
+
+    REQUIRE_THROWS_AS(InternedString{""}, std::invalid_argument);
+
+    Context<Substring> substrings;
+    for (auto const& str: { "011101", "0110101110010101110", "abracadabra", "AAAAAAAAAAAA" }) {
+        Context<InternedString, disassembly_type<InternedString>::value, DenseCache> interned;
+        auto const root = InternedString{str};
+        REQUIRE(interned.assembly_index(root) == substrings.assembly_index(Substring{str}));
+        REQUIRE(interned.assembly_cache_size() <= root.distinct());
+    }
+}
@@ -0,0 +1,79 @@
+#include "catch2/catch.hpp"
+#include <pathways/packed.h>
+#include <pathways/string.h>
+#include <random>
+
+namespace {
+    template <typename Alphabet>
+    auto random_symbols(std::size_t n, std::mt19937 &gen) -> std::string {
+        auto const symbols = std::string_view(Alphabet::symbols);
+        std::uniform_int_distribution<std::size_t> d(0, std::size(symbols) - 1);
+        auto str = std::string(n, '\0');
+        for (auto& c: str) {
+            c = symbols[d(gen)];
+        }
+        return str;
+    }
+}
+
+TEMPLATE_TEST_CASE("packed strings satisfy the pathways interface", "[packed]", pathways::BinaryAlphabet, pathways::QuaternaryAlphabet) {
+    using namespace pathways;
+    using Packed = PackedString<TestType>;
+
+    std::mt19937 gen(2718);
+    auto const str = random_symbols<TestType>(150, gen);
+    auto const packed = Packed{str};
+
+    SECTION("cannot be empty or hold foreign symbols") {
+        REQUIRE_THROWS_AS(Packed{""}, std::invalid_argument);
+        REQUIRE_THROWS_AS(Packed{"0A"}, std::invalid_argument);
+        REQUIRE(Packed::encodes(str));
+        REQUIRE(!Packed::encodes("xyz"));
+    }
+
+    SECTION("unpack to the strings they were packed from") {
+        REQUIRE(std::size(packed) == std::size(str));
+        REQUIRE(packed.str() == str);
+    }
+
+    SECTION("substrings agree with packed substrings at every offset") {
+        for (std::size_t pos = 0; pos < std::size(str); pos += 7) {
+            for (std::size_t n = 1; pos + n <= std::size(str); n += 5) {
+                auto const sub = packed.substr(pos, n);
+                REQUIRE(sub == Packed{str.substr(pos, n)});
+                REQUIRE(std::hash<Packed>{}(sub) == std::hash<Packed>{}(Packed{str.substr(pos, n)}));
+                REQUIRE(sub.str() == str.substr(pos, n));
+            }
+        }
+    }
+
+    SECTION("containment agrees with std::string") {
+        for (std::size_t n = 1; n <= 80; n += 3) {
+            auto const needle = random_symbols<TestType>(n, gen);
+            auto const window = str.substr(n, n);
+            REQUIRE(is_below(Packed{needle}, packed) == (str.find(needle) != std::string::npos));
+            REQUIRE(is_below(Packed{window}, packed));
+            REQUIRE(is_below(packed, Packed{window}) == (n == std::size(str)));
+        }
+    }
+
+    SECTION("disassemble into the same components as strings") {
+        auto const parts = disassemble(str);
+        auto expected = std::begin(parts);
+        for (auto const& [x, y]: disassemble(packed)) {
+            auto const [head, tail] = *expected++;
+            REQUIRE(x.str() == head);
+            REQUIRE(y.str() == tail);
+        }
+        REQUIRE(expected == std::end(parts));
+    }
+
+    SECTION("agree with strings") {
+        Context<std::string> strings;
+        Context<Packed> packeds;
+        for (std::size_t n = 5; n <= 40; n += 7) {
+            auto const s = random_symbols<TestType>(n, gen);
+            REQUIRE(packeds.assembly_index(Packed{s}) == strings.assembly_index(s));
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "catch2/catch.hpp"
+#include <pathways/addition.h>
+#include <pathways/search.h>
+#include <pathways/string.h>
+#include <random>
+
+TEST_CASE("search kernels agree with std::string::find", "[search]") {
+    using namespace pathways;
+
+    std::mt19937 gen(1618);
+    auto const random_text = [&gen](std::size_t n, int alphabet) {
+        std::uniform_int_distribution<int> d(0, alphabet - 1);
+        auto str = std::string(n, '\0');
+        for (auto& c: str) {
+            c = static_cast<char>('0' + d(gen));
+        }
+        return str;
+    };
+
+    for (auto const kernel: { HashKernel::scalar, HashKernel::sse, HashKernel::avx2 }) {
+        auto const search = simd::search_kernel(kernel);
+        for (auto const alphabet: { 2, 4, 64 }) {
+            for (std::size_t n = 1; n <= 130; n += 3) {
+                auto const haystack = random_text(n, alphabet);
+                for (std::size_t k = 0; k <= n + 1; k += 1 + k / 4) {
+                    auto const needle = random_text(k, alphabet);
+                    auto const expected = haystack.find(needle) != std::string::npos;
+                    REQUIRE(simd_contains(haystack, needle, search) == expected);
+                    if (k <= n) {
+                        auto const window = haystack.substr(n - k, k);
+                        REQUIRE(simd_contains(haystack, window, search));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("objects can be related in both directions at once", "[search]") {
+    using namespace pathways;
+
+    SECTION("by default, by asking is_below twice") {
+        REQUIRE(relation(2, 3) == Relation::below);
+        REQUIRE(relation(3, 3) == Relation::below);
+        REQUIRE(relation(3, 2) == Relation::above);
+    }
+
+    SECTION("strings, with a single search") {
+        auto const strs = std::vector<std::string>{ "0", "1", "01", "10", "0110", "1001", "0110100", "011010" };
+        for (auto const& x: strs) {
+            for (auto const& y: strs) {
+                auto const expected = is_below(x, y) ? Relation::below
+                                    : is_below(y, x) ? Relation::above
+                                    : Relation::incomparable;
+                REQUIRE(relation(x, y) == expected);
+            }
+        }
+    }
+}
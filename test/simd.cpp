@@ -0,0 +1,64 @@
+#include "catch2/catch.hpp"
+#include <pathways/simd.h>
+#include <pathways/string.h>
+#include <random>
+
+TEST_CASE("hash kernels agree with one another", "[simd]") {
+    using namespace pathways;
+
+    auto gen = std::mt19937{2019};
+    auto byte = std::uniform_int_distribution<int>{0, 255};
+    auto const scalar = simd::kernel(HashKernel::scalar);
+    auto const sse = simd::kernel(HashKernel::sse);
+    auto const avx2 = simd::kernel(HashKernel::avx2);
+    for (std::size_t n = 0; n <= 300; ++n) {
+        auto str = std::string(n, '\0');
+        for (auto& c: str) {
+            c = static_cast<char>(byte(gen));
+        }
+        auto const h = simd_hash(str);
+        REQUIRE(simd_hash(str, scalar) == h);
+        REQUIRE(simd_hash(str, sse) == h);
+        REQUIRE(simd_hash(str, avx2) == h);
+        REQUIRE(StringHash{}(str) == h);
+    }
+}
+
+TEST_CASE("strings hash differently", "[simd]") {
+    using namespace pathways;
+
+    SECTION("by length") {
+        for (std::size_t n = 1; n <= 100; ++n) {
+            REQUIRE(simd_hash(std::string(n, '\0')) != simd_hash(std::string(n + 1, '\0')));
+            REQUIRE(simd_hash(std::string(n, '0')) != simd_hash(std::string(n + 1, '0')));
+        }
+    }
+
+    SECTION("by every character") {
+        auto const str = std::string(200, '0');
+        auto const h = simd_hash(str);
+        for (std::size_t i = 0; i < std::size(str); ++i) {
+            auto flipped = str;
+            flipped[i] = '1';
+            REQUIRE(simd_hash(flipped) != h);
+        }
+    }
+
+    SECTION("by the order of their stripes") {
+        auto const a = std::string(32, '0');
+        auto const b = std::string(32, '1');
+        REQUIRE(simd_hash(a + b + a) != simd_hash(b + a + a));
+        REQUIRE(simd_hash(a + b + a) != simd_hash(a + a + b));
+    }
+}
+
+TEST_CASE("string contexts agree whichever hash they use", "[simd]") {
+    using namespace pathways;
+
+    Context<std::string, disassembly_type<std::string>::value, FlatCache, std::hash<std::string>> std_hashed;
+    Context<std::string> simd_hashed;
+    static_assert(std::is_same_v<std::decay_t<decltype(simd_hashed.hasher())>, StringHash>);
+    for (auto const& str: { "011101", "0110101110010101110", "abracadabra", "AAAAAAAAAAAA" }) {
+        REQUIRE(simd_hashed.assembly_index(str) == std_hashed.assembly_index(str));
+    }
+}
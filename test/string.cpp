@@ -0,0 +1,44 @@
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <pathways/string.h>
+#include <vector>
+
+TEST_CASE("strings satisfy the pathways interface", "[string]") {
+    using namespace pathways;
+
+    SECTION("is_basic") {
+        REQUIRE(is_basic(std::string{"a"}));
+        REQUIRE(!is_basic(std::string{"ab"}));
+    }
+
+    SECTION("is_below") {
+        REQUIRE(is_below(std::string{"bc"}, std::string{"abcd"}));
+        REQUIRE(!is_below(std::string{"abcd"}, std::string{"bc"}));
+    }
+
+    SECTION("disassemble throws for the empty string") {
+        REQUIRE_THROWS_AS(disassemble(std::string{}), std::invalid_argument);
+    }
+
+    SECTION("disassemble returns a range with the correct length") {
+        auto const str = std::string{"a"};
+        auto const parts = disassemble(str);
+        REQUIRE(parts.empty());
+        REQUIRE(!(std::begin(parts) != std::end(parts)));
+        for (std::size_t n = 2; n <= 10; ++n) {
+            auto const longer = std::string(n, 'a');
+            auto const range = disassemble(longer);
+            REQUIRE(std::size(range) == n - 1);
+            REQUIRE(static_cast<std::size_t>(std::distance(std::begin(range), std::end(range))) == n - 1);
+        }
+    }
+
+    SECTION("can disassemble a string") {
+        auto const expected = std::vector<Components<std::string>>{ {"a", "bcd"}, {"ab", "cd"}, {"abc", "d"} };
+        auto const str = std::string{"abcd"};
+        auto const got = disassemble(str);
+
+        REQUIRE(std::size(got) == std::size(expected));
+        REQUIRE(std::equal(std::begin(got), std::end(got), std::begin(expected)));
+    }
+}
@@ -0,0 +1,68 @@
+#include "catch2/catch.hpp"
+#include <pathways/string.h>
+#include <pathways/string_view.h>
+#include <pathways/substring.h>
+
+TEST_CASE("prefix hashes can be rolled along a string", "[string_view]") {
+    using namespace pathways;
+
+    auto const str = std::string_view{"0110101110010101110"};
+    auto const base = PrefixHash::default_base;
+    REQUIRE(PrefixHash::times(base, PrefixHash::inverse(base)) == 1);
+    REQUIRE(PrefixHash::pow(base, 3) == PrefixHash::times(base, PrefixHash::times(base, base)));
+    for (std::size_t i = 0; i + 1 < std::size(str); ++i) {
+        auto const tail = str.substr(i);
+        auto const power = PrefixHash::pow(base, std::size(tail) - 1);
+        REQUIRE(PrefixHash::remove_front(PrefixHash::hash(tail), tail[0], power) == PrefixHash::hash(tail.substr(1)));
+        REQUIRE(PrefixHash::append(PrefixHash::hash(str.substr(0, i)), str[i]) == PrefixHash::hash(str.substr(0, i + 1)));
+    }
+}
+
+TEST_CASE("string views disassemble lazily", "[string_view]") {
+    using namespace pathways;
+
+    REQUIRE_THROWS_AS(disassemble(std::string_view{}), std::invalid_argument);
+
+    SECTION("into every split, with their hashes") {
+        auto const str = std::string_view{"abracadabra"};
+        auto const parts = disassemble(str);
+        REQUIRE(std::size(parts) == std::size(str) - 1);
+        auto split = std::size_t{1};
+        for (auto const& [head, head_hash, tail, tail_hash]: parts) {
+            REQUIRE(head == str.substr(0, split));
+            REQUIRE(tail == str.substr(split));
+            REQUIRE(std::data(head) == std::data(str));
+            REQUIRE(head_hash == PolynomialHash{}(head));
+            REQUIRE(tail_hash == PolynomialHash{}(tail));
+            ++split;
+        }
+        REQUIRE(split == std::size(str));
+    }
+
+    SECTION("into nothing if they are basic") {
+        auto const parts = disassemble(std::string_view{"a"});
+        REQUIRE(!(parts.begin() != parts.end()));
+    }
+
+    SECTION("until the last split, even if heads or tails repeat") {
+        auto count = std::size_t{0};
+        for (auto const& parts: disassemble(std::string_view{"aaaa"})) {
+            static_cast<void>(parts);
+            ++count;
+        }
+        REQUIRE(count == 3);
+    }
+}
+
+TEST_CASE("string views agree with strings", "[string_view]") {
+    using namespace pathways;
+
+    Context<std::string> strings;
+    Context<std::string_view> views;
+    Context<std::string_view, disassembly_type<std::string_view>::value, FlatCache, std::hash<std::string_view>> std_hashed;
+    for (auto const& str: { "011101", "0110101110010101110", "abracadabra", "AAAAAAAAAAAA" }) {
+        auto const c = strings.assembly_index(str);
+        REQUIRE(views.assembly_index(str) == c);
+        REQUIRE(std_hashed.assembly_index(str) == c);
+    }
+}
@@ -0,0 +1,131 @@
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <iterator>
+#include <pathways/string.h>
+#include <pathways/substring.h>
+
+TEST_CASE("prefix hashes agree with direct hashes", "[substring]") {
+    using namespace pathways;
+
+    auto const str = std::string{"0110101110010101110"};
+    auto const hash = PrefixHash{str};
+    REQUIRE(hash.size() == std::size(str));
+    for (std::size_t i = 0; i < std::size(str); ++i) {
+        for (std::size_t n = 1; i + n <= std::size(str); ++n) {
+            REQUIRE(hash(i, n) == PrefixHash::hash(std::string_view(str).substr(i, n)));
+        }
+    }
+    REQUIRE(PrefixHash::hash("a") != PrefixHash::hash(std::string("\0a", 2)));
+}
+
+TEST_CASE("substrings satisfy the pathways interface", "[substring]") {
+    using namespace pathways;
+
+    SECTION("cannot be empty") {
+        REQUIRE_THROWS_AS(Substring{""}, std::invalid_argument);
+    }
+
+    SECTION("equal substrings hash equally") {
+        auto const str = Substring{"abcabc"};
+        auto const parts = disassemble(str);
+        REQUIRE(std::size(parts) == 5);
+        auto iter = std::begin(parts);
+        ++iter;
+        ++iter;
+        auto const [x, y] = *iter;
+        REQUIRE(x.view() == "abc");
+        REQUIRE(y.view() == "abc");
+        REQUIRE(x == y);
+        REQUIRE(std::hash<Substring>{}(x) == std::hash<Substring>{}(y));
+        REQUIRE(std::hash<Substring>{}(x) == std::hash<Substring>{}(Substring{"abc"}));
+        REQUIRE(is_below(x, str));
+        REQUIRE(!is_below(str, x));
+    }
+
+    SECTION("disassemble lazily into the same components as strings") {
+        auto const str = std::string{"0110101110"};
+        auto const parts = disassemble(str);
+        auto expected = std::begin(parts);
+        for (auto const& [x, y]: disassemble(Substring{str})) {
+            REQUIRE(expected != std::end(parts));
+            auto const [head, tail] = *expected++;
+            REQUIRE(x.view() == head);
+            REQUIRE(y.view() == tail);
+        }
+        REQUIRE(expected == std::end(parts));
+        auto const lazy = disassemble(Substring{str});
+        auto const equal = std::count_if(std::begin(lazy), std::end(lazy), [](auto const& part) {
+            return part.first == part.second;
+        });
+        REQUIRE(equal == 0);
+        REQUIRE(std::distance(std::begin(lazy), std::end(lazy)) == 9);
+        auto const basic = disassemble(Substring{"a"});
+        REQUIRE(std::size(basic) == 0);
+        REQUIRE(!(std::begin(basic) != std::end(basic)));
+    }
+
+    SECTION("agree with strings") {
+        Context<std::string> strings;
+        Context<Substring> substrings;
+        for (auto const& str: { "011101", "0110101110010101110", "abracadabra", "AAAAAAAAAAAA" }) {
+            REQUIRE(substrings.assembly_index(Substring{str}) == strings.assembly_index(str));
+        }
+    }
+}
+
+TEST_CASE("objects can be fingerprinted", "[substring]") {
+    using namespace pathways;
+
+    SECTION("strings") {
+        auto const hash = FingerprintHash<std::string>{};
+        REQUIRE(hash("abcdefghijk") == hash("abcdefghijk"));
+        REQUIRE(hash("abcdefghijk") != hash("abcdefghijl"));
+        REQUIRE(hash("a") != hash(std::string("a\0", 2)));
+    }
+
+    SECTION("substrings") {
+        auto const str = Substring{"abcabc"};
+        auto const parts = disassemble(str);
+        auto iter = std::begin(parts);
+        ++iter;
+        ++iter;
+        auto const [x, y] = *iter;
+        REQUIRE(x.fingerprint() == y.fingerprint());
+        REQUIRE(x.fingerprint() != str.fingerprint());
+        REQUIRE(x.fingerprint().high == std::hash<Substring>{}(x));
+    }
+
+    SECTION("fingerprinted contexts agree with hashed contexts") {
+        Context<Substring> hashed;
+        Context<Substring, disassembly_type<Substring>::value, FlatCache, FingerprintHash<Substring>> substrings;
+        Context<std::string, disassembly_type<std::string>::value, MapCache, FingerprintHash<std::string>> strings;
+        for (auto const& str: { "011101", "0110101110010101110", "abracadabra" }) {
+            auto const c = hashed.assembly_index(Substring{str});
+            REQUIRE(substrings.assembly_index(Substring{str}) == c);
+            REQUIRE(strings.assembly_index(str) == c);
+        }
+    }
+}
+
+TEST_CASE("audited hashers count collisions", "[substring]") {
+    using namespace pathways;
+
+    struct Length {
+        auto operator()(std::string const& str) const noexcept -> std::size_t {
+            return std::size(str);
+        }
+    };
+
+    auto const audit = Audited<std::string, Length>{};
+    audit("ab");
+    audit("ab");
+    audit("cd");
+    audit("abc");
+    REQUIRE(audit.objects() == 3);
+    REQUIRE(audit.collisions() == 1);
+
+    Context<std::string, disassembly_type<std::string>::value, FlatCache, Audited<std::string>> ctx;
+    ctx.assembly_index("0110101110010101110");
+    REQUIRE(ctx.hasher().objects() > 0);
+    REQUIRE(ctx.hasher().collisions() == 0);
+}
@@ -0,0 +1,76 @@
+#include "catch2/catch.hpp"
+#include <pathways/substring.h>
+#include <pathways/suffix.h>
+#include <random>
+
+TEST_CASE("suffix indices agree with searching the string", "[suffix]") {
+    using namespace pathways;
+
+    std::mt19937 gen(1414);
+    auto const random_text = [&gen](std::size_t n, int alphabet) {
+        std::uniform_int_distribution<int> d(0, alphabet - 1);
+        auto str = std::string(n, '\0');
+        for (auto& c: str) {
+            c = static_cast<char>('a' + d(gen));
+        }
+        return str;
+    };
+
+    SECTION("suffixes are sorted, with their common prefixes") {
+        for (auto const& str: { std::string{"a"}, std::string{"banana"}, std::string(40, 'a'), random_text(97, 3) }) {
+            auto const index = SuffixIndex{str};
+            auto const view = std::string_view(str);
+            REQUIRE(index.size() == std::size(str));
+            for (std::size_t r = 0; r < std::size(str); ++r) {
+                REQUIRE(index.rank(index.suffix(r)) == r);
+                if (r > 0) {
+                    REQUIRE(view.substr(index.suffix(r - 1)) < view.substr(index.suffix(r)));
+                }
+            }
+            for (std::size_t i = 0; i < std::size(str); ++i) {
+                for (std::size_t j = 0; j < std::size(str); ++j) {
+                    auto h = std::size_t{0};
+                    while (i + h < std::size(str) && j + h < std::size(str) && str[i + h] == str[j + h]) {
+                        ++h;
+                    }
+                    REQUIRE(index.lcp(i, j) == h);
+                }
+            }
+        }
+    }
+
+    SECTION("substrings occur within one another exactly when find says so") {
+        for (auto const alphabet: { 2, 4 }) {
+            for (auto const n: { 1, 7, 33, 120 }) {
+                auto const str = random_text(n, alphabet);
+                auto const view = std::string_view(str);
+                auto const index = SuffixIndex{str};
+                for (std::size_t i = 0; i < std::size(str); i += 1 + i / 8) {
+                    for (std::size_t m = 1; i + m <= std::size(str); m += 1 + m / 4) {
+                        for (std::size_t k = 0; k < std::size(str); k += 1 + k / 6) {
+                            for (std::size_t l = 1; k + l <= std::size(str); l += 1 + l / 3) {
+                                auto const expected = view.substr(k, l).find(view.substr(i, m)) != std::string_view::npos;
+                                REQUIRE(index.occurs(i, m, k, l) == expected);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("substrings of a root are related through its index") {
+        auto const str = random_text(60, 2);
+        auto const root = Substring{str};
+        auto const other = Substring{str.substr(10, 20)};
+        auto const parts = disassemble(root);
+        for (auto const& [x, y]: parts) {
+            REQUIRE(is_below(x, y) == (y.view().find(x.view()) != std::string_view::npos));
+            REQUIRE(is_below(other, x) == (x.view().find(other.view()) != std::string_view::npos));
+            auto const expected = is_below(x, y) ? Relation::below
+                                : is_below(y, x) ? Relation::above
+                                : Relation::incomparable;
+            REQUIRE(relation(x, y) == expected);
+        }
+    }
+}